@@ -0,0 +1,6 @@
+#pragma once
+#include <cstddef>
+
+// Linking allocation_counter.cpp replaces the global operator new, so that benchmarks can tell
+// how many allocations an operation costs. Returns the number made so far by the process.
+std::size_t allocation_count();
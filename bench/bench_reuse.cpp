@@ -0,0 +1,108 @@
+#include "parser.h"
+#include "allocation_counter.h"
+#include <string>
+#include <memory>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <functional>
+#include <cstddef>
+
+using namespace yajp;
+
+// A message of the size a service typically receives: records with short keys, strings,
+// numbers and a nested object each.
+std::string make_message(std::size_t records)
+{
+    std::string message = "{\"source\": \"ingest-7\", \"records\": [";
+    for (std::size_t i = 0; i < records; i++)
+    {
+        std::string id = std::to_string(i);
+        message += i == 0 ? "" : ", ";
+        message += "{\"id\": " + id + ", \"name\": \"user " + id +
+                   "\", \"score\": " + std::to_string(i * 0.37) +
+                   ", \"active\": true, \"tags\": [\"a\", \"b\\n\"], "
+                   "\"location\": {\"lat\": 52.52, \"lon\": 13.405, \"city\": \"Berlin\"}}";
+    }
+    message += "]}";
+    return message;
+}
+
+// Parses the message `count` times after a warm-up round, returns the allocations per document.
+std::size_t measure(
+    const char* name, const std::string& message, const std::function<void()>& parse)
+{
+    constexpr int warmup = 3;
+    constexpr int count = 2000;
+    for (int i = 0; i < warmup; i++)
+    {
+        parse();
+    }
+    std::size_t before = allocation_count();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; i++)
+    {
+        parse();
+    }
+    auto stop = std::chrono::steady_clock::now();
+    std::size_t per_document = (allocation_count() - before) / count;
+    double seconds = std::chrono::duration<double>(stop - start).count();
+    std::cout << std::setw(28) << name << std::setw(12)
+              << static_cast<double>(message.size()) * count / seconds / 1e6 << std::setw(16)
+              << per_document << '\n';
+    return per_document;
+}
+
+int main()
+{
+    const std::string message = make_message(100);
+    std::cout << "message of " << message.size() << " bytes\n"
+              << std::left << std::setw(28) << "case" << std::setw(12) << "MB/s"
+              << "allocations/doc\n"
+              << std::fixed << std::setprecision(0);
+
+    measure("new parser, Value", message, [&]() {
+        Parser parser;
+        Value value = parser.parse(message);
+    });
+
+    Parser parser;
+    measure("reused parser, Value", message, [&]() {
+        Value value = parser.parse(message);
+    });
+
+    Document document;
+    std::size_t tree = measure("reused parser, Document", message, [&]() {
+        parser.parse(message, document);
+    });
+
+    Parser::Options options;
+    options.engine = Parser::Engine::Descent;
+    Parser descent(options);
+    measure("reused descent, Value", message, [&]() {
+        Value value = descent.parse(message);
+    });
+    std::size_t descent_tree = measure("reused descent, Document", message, [&]() {
+        descent.parse(message, document);
+    });
+
+    TapeDocument tape;
+    std::size_t flat = measure("reused parser, TapeDocument", message, [&]() {
+        parser.parse(message, tape);
+    });
+
+    Parser::Options interning;
+    interning.keys = std::make_shared<KeyTable>();
+    Parser interned_parser(interning);
+    std::size_t interned = measure("interned keys, Tape", message, [&]() {
+        interned_parser.parse(message, tape);
+    });
+
+    if (tree != 0 || descent_tree != 0 || flat != 0 || interned != 0)
+    {
+        std::cerr << "Recycled documents should parse without allocating.\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include "string_scan.h"
+#include "simd.h"
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <cctype>
+#include <cstddef>
+
+using namespace yajp;
+
+// The scanner used by Tokenizer::scan_string before the vectorized fast path, without the
+// escape validation, which both versions share.
+const char* scan_string_bytewise(const char* c)
+{
+    while (*c != '"' && !std::iscntrl(static_cast<unsigned char>(*c)))
+    {
+        if (*c == '\\')
+        {
+            c++;
+        }
+        c++;
+    }
+    return c;
+}
+
+const char* scan_string_blockwise(const char* c, const char* last, simd::Level level)
+{
+    while (true)
+    {
+        c = find_string_special(c, last, level);
+        if (c == last || *c != '\\')
+        {
+            return c;
+        }
+        c += 2;
+    }
+}
+
+// Builds the contents of one string literal, including the closing quote, repeated until the
+// buffer holds about `total` bytes.
+std::string make_corpus(const std::string& contents, std::size_t total, std::size_t& count)
+{
+    std::string corpus;
+    count = 0;
+    while (corpus.size() < total)
+    {
+        corpus += contents;
+        corpus += '"';
+        count++;
+    }
+    return corpus;
+}
+
+template <typename Scan>
+double measure(const std::string& corpus, std::size_t count, Scan scan)
+{
+    constexpr int repetitions = 20;
+    const char* last = corpus.data() + corpus.size();
+    std::size_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repetitions; i++)
+    {
+        const char* c = corpus.data();
+        for (std::size_t j = 0; j < count; j++)
+        {
+            c = scan(c, last) + 1;
+        }
+        checksum += static_cast<std::size_t>(c - corpus.data());
+    }
+    auto stop = std::chrono::steady_clock::now();
+    if (checksum != corpus.size() * repetitions)
+    {
+        std::cerr << "Scanners disagree on the corpus.\n";
+    }
+    double seconds = std::chrono::duration<double>(stop - start).count();
+    return static_cast<double>(corpus.size()) * repetitions / seconds / 1e6;
+}
+
+int main()
+{
+    constexpr std::size_t total = 16 * 1024 * 1024;
+    std::string long_text;
+    for (int i = 0; i < 40; i++)
+    {
+        long_text += "2024-05-01T12:00:00Z worker-17 request served in 12ms ";
+    }
+    std::string escaped_text;
+    for (int i = 0; i < 100; i++)
+    {
+        escaped_text += R"(line \"quoted\"\n\tpath C:\\dir\\file \u00e9)";
+    }
+    const std::vector<std::pair<const char*, std::string>> cases = {
+        {"short", "user_id"},
+        {"long", long_text},
+        {"escape-heavy", escaped_text},
+    };
+
+    std::cout << std::left << std::setw(14) << "case" << std::setw(12) << "bytewise";
+    const char* level_names[] = {"scalar", "sse2", "avx2"};
+    int best = static_cast<int>(simd::detect());
+    for (int level = 0; level <= best; level++)
+    {
+        std::cout << std::setw(12) << level_names[level];
+    }
+    std::cout << "(MB/s)\n" << std::fixed << std::setprecision(0);
+
+    for (const auto& [name, contents] : cases)
+    {
+        std::size_t count;
+        std::string corpus = make_corpus(contents, total, count);
+        std::cout << std::setw(14) << name << std::setw(12)
+                  << measure(corpus, count, [](const char* c, const char*) {
+                         return scan_string_bytewise(c);
+                     });
+        for (int level = 0; level <= best; level++)
+        {
+            std::cout << std::setw(12)
+                      << measure(corpus, count, [level](const char* c, const char* last) {
+                             return scan_string_blockwise(c, last, static_cast<simd::Level>(level));
+                         });
+        }
+        std::cout << '\n';
+    }
+
+    return 0;
+}
@@ -0,0 +1,420 @@
+#include "parser.h"
+#include "tokenizer.h"
+#include "allocation_counter.h"
+#include "binding.h"
+#include "serializer.h"
+#include "typed_serializer.h"
+#include <string>
+#include <vector>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <random>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+
+using namespace yajp;
+
+// Typed views of the tweets and tiny corpora, with only part of their members.
+struct TweetUser
+{
+    std::uint64_t id = 0;
+    std::string screen_name;
+    std::uint64_t followers_count = 0;
+    bool verified = false;
+};
+
+struct Tweet
+{
+    std::uint64_t id = 0;
+    std::string text;
+    TweetUser user;
+    std::uint32_t retweet_count = 0;
+    std::string lang;
+};
+
+struct SearchResult
+{
+    std::vector<Tweet> statuses;
+};
+
+struct Message
+{
+    std::uint32_t id = 0;
+    std::string op;
+    bool ok = false;
+    double value = 0;
+};
+
+YAJP_BIND(TweetUser, id, screen_name, followers_count, verified)
+YAJP_BIND(Tweet, id, text, user, retweet_count, lang)
+YAJP_BIND(SearchResult, statuses)
+YAJP_BIND(Message, id, op, ok, value)
+
+// The benchmark suite: a few corpora which stand for the documents the library is used on, each
+// run through the main entry points. Everything is generated from fixed seeds, so the numbers
+// of two builds can be compared directly.
+//
+//     yajp_bench [--time SECONDS] [CORPUS...]
+
+namespace
+{
+
+struct Corpus
+{
+    const char* name;
+    std::vector<std::string> documents;
+};
+
+struct Operation
+{
+    const char* name;
+    // Returns something derived from the result, so that the work cannot be optimized away.
+    std::function<std::size_t(const std::string&)> run;
+    // Only runs on this corpus if set.
+    const char* corpus = nullptr;
+    // Called before the corpus is measured, for operations which start from parsed documents.
+    std::function<void(const Corpus&)> prepare = nullptr;
+};
+
+// Parsed documents of a corpus for the serializers. Documents are always run in corpus order,
+// so each call takes the next one.
+template <typename T>
+struct Parsed
+{
+    std::vector<T> values;
+    std::size_t next = 0;
+
+    const T& take()
+    {
+        const T& value = values[next];
+        next = (next + 1) % values.size();
+        return value;
+    }
+};
+
+// Corpora of a single document are grown to about this size.
+constexpr std::size_t CorpusSize = 4 * 1024 * 1024;
+
+std::string number(double value)
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.15g", value);
+    return buffer;
+}
+
+std::string word(std::mt19937_64& random)
+{
+    static const char* words[] = {
+        "the", "json", "parser", "release", "today", "fast", "stream", "café", "data", "open",
+        "source", "build", "night", "coffee", "benchmark", "tokyo", "Zürich", "again",
+    };
+    return words[random() % (sizeof(words) / sizeof(words[0]))];
+}
+
+// Search results in the shape of a social network's API: nested user objects, entity arrays,
+// escaped URLs and a mix of short strings, integers and nulls.
+Corpus tweets()
+{
+    std::mt19937_64 random(1);
+    std::string document = R"({"statuses": [)";
+    for (std::size_t i = 0; document.size() < CorpusSize; i++)
+    {
+        std::string id = std::to_string(1580000000000000000ULL + random() % 1000000000000ULL);
+        std::string user = "user" + std::to_string(random() % 100000);
+        std::string text;
+        for (int k = 0; k < 12; k++)
+        {
+            text += word(random) + ' ';
+        }
+        document += i == 0 ? "" : ",";
+        document += R"({"created_at": "Mon Oct 17 12:)" + std::to_string(10 + i % 50) +
+                    R"(:00 +0000 2026", "id": )" + id + R"(, "id_str": ")" + id +
+                    R"(", "text": "@)" + user + ' ' + text +
+                    R"(#json ❤ https:\/\/t.co\/)" + std::to_string(random() % 1000000) +
+                    R"(", "truncated": false, "entities": {"hashtags": [{"text": "json", )"
+                    R"("indices": [)" + std::to_string(text.size()) + ", " +
+                    std::to_string(text.size() + 5) + R"(]}], "urls": [], "user_mentions": [)"
+                    R"({"screen_name": ")" + user + R"(", "indices": [0, )" +
+                    std::to_string(user.size() + 1) + R"(]}]}, "user": {"id": )" +
+                    std::to_string(random() % 10000000) + R"(, "name": "Some \"Name\"", )"
+                    R"("screen_name": ")" + user + R"(", "location": ")" + word(random) +
+                    R"(", "followers_count": )" + std::to_string(random() % 100000) +
+                    R"(, "verified": )" + (random() % 10 == 0 ? "true" : "false") +
+                    R"(, "profile_background_color": "C0DEED", "profile_image_url": null}, )"
+                    R"("geo": null, "coordinates": null, "retweet_count": )" +
+                    std::to_string(random() % 1000) + R"(, "favorited": false, "lang": "en"})";
+    }
+    document += R"(], "search_metadata": {"count": 100, "query": "json"}})";
+    return {"tweets", {std::move(document)}};
+}
+
+// Map data: polygons of longitude and latitude pairs with full double precision.
+Corpus coordinates()
+{
+    std::mt19937_64 random(2);
+    std::uniform_real_distribution<double> offset(-0.01, 0.01);
+    std::string document = R"({"type": "FeatureCollection", "features": [)";
+    for (std::size_t i = 0; document.size() < CorpusSize; i++)
+    {
+        double longitude = -180.0 + static_cast<double>(random() % 360000) / 1000.0;
+        double latitude = -90.0 + static_cast<double>(random() % 180000) / 1000.0;
+        document += i == 0 ? "" : ",";
+        document += R"({"type": "Feature", "properties": {"id": )" + std::to_string(i) +
+                    R"(}, "geometry": {"type": "Polygon", "coordinates": [[)";
+        for (int k = 0; k < 64; k++)
+        {
+            document += k == 0 ? "[" : ",[";
+            document += number(longitude + offset(random)) + "," +
+                        number(latitude + offset(random)) + "]";
+        }
+        document += "]]}}";
+    }
+    document += "]}";
+    return {"coordinates", {std::move(document)}};
+}
+
+// Objects and arrays nested a few hundred levels deep, with little data at each level.
+Corpus nested()
+{
+    constexpr int depth = 400;
+    std::string document = "[";
+    for (std::size_t i = 0; document.size() < CorpusSize; i++)
+    {
+        document += i == 0 ? "" : ",";
+        for (int level = 0; level < depth; level++)
+        {
+            document += level % 2 == 0 ? R"({"level": )" + std::to_string(level) + R"(, "next": )"
+                                       : std::string("[true, ");
+        }
+        document += "null";
+        for (int level = depth - 1; level >= 0; level--)
+        {
+            document += level % 2 == 0 ? "}" : "]";
+        }
+    }
+    document += "]";
+    return {"nested", {std::move(document)}};
+}
+
+// Long strings full of escapes, such as embedded source code or log excerpts.
+Corpus escaped()
+{
+    std::mt19937_64 random(3);
+    static const char* pieces[] = {
+        R"(\n)", R"(\t)", R"(\")", R"(\\)", R"(\/)", R"(é)", R"(😀)", "text ",
+        "more words ", "x",
+    };
+    std::string document = "[";
+    for (std::size_t i = 0; document.size() < CorpusSize; i++)
+    {
+        document += i == 0 ? "\"" : ",\"";
+        for (int k = 0; k < 2000; k++)
+        {
+            document += pieces[random() % (sizeof(pieces) / sizeof(pieces[0]))];
+        }
+        document += "\"";
+    }
+    document += "]";
+    return {"escaped", {std::move(document)}};
+}
+
+// Many small independent documents, as a message queue or an RPC server sees them.
+Corpus tiny()
+{
+    std::mt19937_64 random(4);
+    Corpus corpus{"tiny", {}};
+    for (std::size_t size = 0; size < CorpusSize / 4;)
+    {
+        std::string document = R"({"id": )" + std::to_string(random() % 1000000) +
+                               R"(, "op": ")" + word(random) + R"(", "ok": true, "value": )" +
+                               number(static_cast<double>(random() % 100000) / 100.0) + "}";
+        size += document.size();
+        corpus.documents.push_back(std::move(document));
+    }
+    return corpus;
+}
+
+// Parses every document of a corpus into a T.
+template <typename T>
+std::function<void(const Corpus&)> parse_all(
+    const std::shared_ptr<Parser>& parser, const std::shared_ptr<Parsed<T>>& parsed)
+{
+    return [parser, parsed](const Corpus& corpus) {
+        parsed->values.assign(corpus.documents.size(), T());
+        parsed->next = 0;
+        for (std::size_t i = 0; i < corpus.documents.size(); i++)
+        {
+            if constexpr (std::is_same_v<T, Value>)
+            {
+                parsed->values[i] = parser->parse(corpus.documents[i]);
+            }
+            else
+            {
+                parser->parse_into(corpus.documents[i], parsed->values[i]);
+            }
+        }
+    };
+}
+
+std::vector<Operation> operations()
+{
+    // each operation keeps its parser, as a server would
+    auto parser = std::make_shared<Parser>();
+    Parser::Options options;
+    options.engine = Parser::Engine::Descent;
+    auto descent = std::make_shared<Parser>(options);
+    auto serializer = std::make_shared<Serializer>();
+    auto typed_serializer = std::make_shared<TypedSerializer>();
+    auto values = std::make_shared<Parsed<Value>>();
+    auto results = std::make_shared<Parsed<SearchResult>>();
+    auto messages = std::make_shared<Parsed<Message>>();
+    return {
+        {"parse",
+         [parser](const std::string& document) {
+             return static_cast<std::size_t>(parser->parse(document).type());
+         }},
+        {"parse (descent)",
+         [descent](const std::string& document) {
+             return static_cast<std::size_t>(descent->parse(document).type());
+         }},
+        {"parse_lazy",
+         [parser](const std::string& document) {
+             return static_cast<std::size_t>(parser->parse_lazy(document).root().type());
+         }},
+        {"validate",
+         [parser](const std::string& document) {
+             return static_cast<std::size_t>(parser->validate(document).error);
+         }},
+        {"Tokenizer::all",
+         [](const std::string& document) { return Tokenizer(document).all().size(); }},
+        {"parse_into",
+         [parser, result = std::make_shared<SearchResult>()](const std::string& document) {
+             parser->parse_into(document, *result);
+             return result->statuses.size();
+         },
+         "tweets"},
+        {"parse_into",
+         [parser, message = std::make_shared<Message>()](const std::string& document) {
+             parser->parse_into(document, *message);
+             return static_cast<std::size_t>(message->id);
+         },
+         "tiny"},
+        // throughput is relative to the input documents, the typed serializers write only the
+        // bound members
+        {"serialize",
+         [serializer, values](const std::string&) {
+             return serializer->serialize(values->take()).size();
+         },
+         nullptr, parse_all(parser, values)},
+        {"serialize_typed",
+         [typed_serializer, results](const std::string&) {
+             return typed_serializer->serialize(results->take()).size();
+         },
+         "tweets", parse_all(parser, results)},
+        {"serialize_typed",
+         [typed_serializer, messages](const std::string&) {
+             return typed_serializer->serialize(messages->take()).size();
+         },
+         "tiny", parse_all(parser, messages)},
+    };
+}
+
+volatile std::size_t sink;
+
+void measure(const Corpus& corpus, const Operation& operation, double minimum_time)
+{
+    std::size_t bytes = 0;
+    for (const std::string& document : corpus.documents)
+    {
+        bytes += document.size();
+    }
+    if (operation.prepare)
+    {
+        operation.prepare(corpus);
+    }
+    std::size_t checksum = 0;
+    // the first pass warms up caches and the parser's buffers
+    for (const std::string& document : corpus.documents)
+    {
+        checksum += operation.run(document);
+    }
+
+    std::size_t passes = 0;
+    std::size_t allocations = allocation_count();
+    auto start = std::chrono::steady_clock::now();
+    double seconds = 0;
+    do
+    {
+        for (const std::string& document : corpus.documents)
+        {
+            checksum += operation.run(document);
+        }
+        passes++;
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    while (seconds < minimum_time);
+    allocations = allocation_count() - allocations;
+
+    double documents = static_cast<double>(corpus.documents.size() * passes);
+    std::cout << std::setw(14) << corpus.name << std::setw(18) << operation.name
+              << std::setw(10) << std::setprecision(0)
+              << static_cast<double>(bytes * passes) / seconds / 1e6 << std::setw(14)
+              << documents / seconds << std::setprecision(1)
+              << static_cast<double>(allocations) / documents << '\n';
+    sink = checksum;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    double minimum_time = 1.0;
+    std::vector<std::string> selected;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--time") == 0 && i + 1 < argc)
+        {
+            minimum_time = std::atof(argv[++i]);
+        }
+        else
+        {
+            selected.push_back(argv[i]);
+        }
+    }
+
+#ifndef NDEBUG
+    std::cerr << "Assertions are enabled, configure with -DCMAKE_BUILD_TYPE=Release for "
+                 "meaningful numbers.\n";
+#endif
+
+    std::vector<Corpus (*)()> generators = {tweets, coordinates, nested, escaped, tiny};
+    std::vector<Operation> all_operations = operations();
+    std::cout << std::left << std::fixed << std::setw(14) << "corpus" << std::setw(18)
+              << "operation" << std::setw(10) << "MB/s" << std::setw(14) << "docs/s"
+              << "allocs/doc\n";
+    for (auto generate : generators)
+    {
+        Corpus corpus = generate();
+        if (!selected.empty() &&
+            std::find(selected.begin(), selected.end(), corpus.name) == selected.end())
+        {
+            continue;
+        }
+        for (const Operation& operation : all_operations)
+        {
+            if (operation.corpus == nullptr || std::strcmp(operation.corpus, corpus.name) == 0)
+            {
+                measure(corpus, operation, minimum_time);
+            }
+        }
+    }
+    return 0;
+}
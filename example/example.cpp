@@ -4,11 +4,10 @@
 #include <sstream>
 #include <iostream>
 #include <iomanip>
-#include <fstream>
 #include <map>
 #include <vector>
 #include <stdexcept>
-#include <utility>
+#include <system_error>
 
 using namespace yajp;
 
@@ -28,6 +27,9 @@ std::string value_to_string(const Value& value, const std::string& separator = "
     case Value::Type::Number:
         oss << value.get<Value::Type::Number>();
         break;
+    case Value::Type::Integer:
+        oss << value.get<Value::Type::Integer>();
+        break;
     case Value::Type::String:
         oss << value.get<Value::Type::String>();
         break;
@@ -87,25 +89,18 @@ int main(int argc, const char** argv)
         return -1;
     }
 
-    std::string content;
-    std::ifstream filestream;
-    filestream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+    Value json;
     try
     {
-        filestream.open(argv[1]);
-        std::ostringstream stringstream;
-        stringstream << filestream.rdbuf();
-        filestream.close();
-        content = stringstream.str();
+        // the file is mapped and tokenized in place instead of being read into a string
+        Parser parser;
+        json = parser.parse_file(argv[1]);
     }
-    catch (const std::ifstream::failure& e)
+    catch (const std::system_error& e)
     {
         std::cerr << "Error: " << e.what() << std::endl;
         return -1;
     }
-
-    Parser parser;
-    Value json = parser.parse(std::move(content));
     try
     {
         std::cout << value_to_string(json);
@@ -0,0 +1,180 @@
+#pragma once
+#include <tuple>
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <optional>
+#include <variant>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+
+namespace yajp
+{
+
+// Describes how a struct maps to a JSON object, for Parser::parse_into and the typed
+// serializer. Either specialize it with a tuple of fields:
+//
+//     template <>
+//     struct yajp::Binding<Point>
+//     {
+//         static constexpr auto fields = std::make_tuple(
+//             yajp::field("x", &Point::x), yajp::field("y", &Point::y));
+//     };
+//
+// or let YAJP_BIND do the same with the member names as keys, at global scope:
+//
+//     YAJP_BIND(Point, x, y)
+template <typename T>
+struct Binding;
+
+template <typename Class, typename Member>
+struct Field
+{
+    std::string_view name;
+    Member Class::*member;
+};
+
+template <typename Class, typename Member>
+constexpr Field<Class, Member> field(std::string_view name, Member Class::*member)
+{
+    return {name, member};
+}
+
+template <typename T, typename = void>
+struct is_bound : std::false_type
+{};
+
+template <typename T>
+struct is_bound<T, std::void_t<decltype(Binding<T>::fields)>> : std::true_type
+{};
+
+template <typename T>
+constexpr bool is_bound_v = is_bound<T>::value;
+
+template <typename T>
+constexpr std::size_t field_count()
+{
+    return std::tuple_size_v<std::decay_t<decltype(Binding<T>::fields)>>;
+}
+
+// The keys of a bound struct in declaration order.
+template <typename T>
+constexpr std::array<std::string_view, field_count<T>()> field_names()
+{
+    return std::apply(
+        [](const auto&... fields) {
+            return std::array<std::string_view, field_count<T>()>{fields.name...};
+        },
+        Binding<T>::fields);
+}
+
+// Traits of the types TypedReader and TypedSerializer handle.
+namespace typed
+{
+
+    template <typename T>
+    struct is_vector : std::false_type
+    {};
+
+    template <typename T, typename Allocator>
+    struct is_vector<std::vector<T, Allocator>> : std::true_type
+    {};
+
+    template <typename T>
+    struct is_optional : std::false_type
+    {};
+
+    template <typename T>
+    struct is_optional<std::optional<T>> : std::true_type
+    {};
+
+    // Maps with string keys, which are read from and written as objects.
+    template <typename T>
+    struct is_map : std::false_type
+    {};
+
+    template <typename T, typename Compare, typename Allocator>
+    struct is_map<std::map<std::string, T, Compare, Allocator>> : std::true_type
+    {};
+
+    template <typename T, typename Hash, typename Equal, typename Allocator>
+    struct is_map<std::unordered_map<std::string, T, Hash, Equal, Allocator>> : std::true_type
+    {};
+
+    template <typename T>
+    struct is_variant : std::false_type
+    {};
+
+    template <typename... T>
+    struct is_variant<std::variant<T...>> : std::true_type
+    {};
+
+    template <typename T>
+    constexpr bool always_false = false;
+
+}
+
+}
+
+#define YAJP_BIND(Type, ...)                                                                       \
+    template <>                                                                                    \
+    struct yajp::Binding<Type>                                                                     \
+    {                                                                                              \
+        using Bound = Type;                                                                        \
+        static constexpr auto fields =                                                             \
+            std::make_tuple(YAJP_BIND_FOR_EACH(YAJP_BIND_FIELD, __VA_ARGS__));                     \
+    };
+
+// Implementation of YAJP_BIND, up to 32 members. The count list ends in a 0 which is never
+// selected, so that the variadic tail of YAJP_BIND_COUNT_ is not empty for a single member.
+#define YAJP_BIND_FIELD(member) ::yajp::field(#member, &Bound::member)
+#define YAJP_BIND_EXPAND(x) x
+#define YAJP_BIND_CONCAT(a, b) YAJP_BIND_CONCAT_(a, b)
+#define YAJP_BIND_CONCAT_(a, b) a##b
+#define YAJP_BIND_COUNT(...)                                                                       \
+    YAJP_BIND_EXPAND(YAJP_BIND_COUNT_(                                                             \
+        __VA_ARGS__, 32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17,               \
+        16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0))
+#define YAJP_BIND_COUNT_(                                                                          \
+    _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16,                         \
+    _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, N, ...)        \
+    N
+#define YAJP_BIND_FOR_EACH(f, ...)                                                                 \
+    YAJP_BIND_EXPAND(                                                                              \
+        YAJP_BIND_CONCAT(YAJP_BIND_EACH_, YAJP_BIND_COUNT(__VA_ARGS__))(f, __VA_ARGS__))
+#define YAJP_BIND_EACH_1(f, x) f(x)
+#define YAJP_BIND_EACH_2(f, x, ...) f(x), YAJP_BIND_EXPAND(YAJP_BIND_EACH_1(f, __VA_ARGS__))
+#define YAJP_BIND_EACH_3(f, x, ...) f(x), YAJP_BIND_EXPAND(YAJP_BIND_EACH_2(f, __VA_ARGS__))
+#define YAJP_BIND_EACH_4(f, x, ...) f(x), YAJP_BIND_EXPAND(YAJP_BIND_EACH_3(f, __VA_ARGS__))
+#define YAJP_BIND_EACH_5(f, x, ...) f(x), YAJP_BIND_EXPAND(YAJP_BIND_EACH_4(f, __VA_ARGS__))
+#define YAJP_BIND_EACH_6(f, x, ...) f(x), YAJP_BIND_EXPAND(YAJP_BIND_EACH_5(f, __VA_ARGS__))
+#define YAJP_BIND_EACH_7(f, x, ...) f(x), YAJP_BIND_EXPAND(YAJP_BIND_EACH_6(f, __VA_ARGS__))
+#define YAJP_BIND_EACH_8(f, x, ...) f(x), YAJP_BIND_EXPAND(YAJP_BIND_EACH_7(f, __VA_ARGS__))
+#define YAJP_BIND_EACH_9(f, x, ...) f(x), YAJP_BIND_EXPAND(YAJP_BIND_EACH_8(f, __VA_ARGS__))
+#define YAJP_BIND_EACH_10(f, x, ...) f(x), YAJP_BIND_EXPAND(YAJP_BIND_EACH_9(f, __VA_ARGS__))
+#define YAJP_BIND_EACH_11(f, x, ...) f(x), YAJP_BIND_EXPAND(YAJP_BIND_EACH_10(f, __VA_ARGS__))
+#define YAJP_BIND_EACH_12(f, x, ...) f(x), YAJP_BIND_EXPAND(YAJP_BIND_EACH_11(f, __VA_ARGS__))
+#define YAJP_BIND_EACH_13(f, x, ...) f(x), YAJP_BIND_EXPAND(YAJP_BIND_EACH_12(f, __VA_ARGS__))
+#define YAJP_BIND_EACH_14(f, x, ...) f(x), YAJP_BIND_EXPAND(YAJP_BIND_EACH_13(f, __VA_ARGS__))
+#define YAJP_BIND_EACH_15(f, x, ...) f(x), YAJP_BIND_EXPAND(YAJP_BIND_EACH_14(f, __VA_ARGS__))
+#define YAJP_BIND_EACH_16(f, x, ...) f(x), YAJP_BIND_EXPAND(YAJP_BIND_EACH_15(f, __VA_ARGS__))
+#define YAJP_BIND_EACH_17(f, x, ...) f(x), YAJP_BIND_EXPAND(YAJP_BIND_EACH_16(f, __VA_ARGS__))
+#define YAJP_BIND_EACH_18(f, x, ...) f(x), YAJP_BIND_EXPAND(YAJP_BIND_EACH_17(f, __VA_ARGS__))
+#define YAJP_BIND_EACH_19(f, x, ...) f(x), YAJP_BIND_EXPAND(YAJP_BIND_EACH_18(f, __VA_ARGS__))
+#define YAJP_BIND_EACH_20(f, x, ...) f(x), YAJP_BIND_EXPAND(YAJP_BIND_EACH_19(f, __VA_ARGS__))
+#define YAJP_BIND_EACH_21(f, x, ...) f(x), YAJP_BIND_EXPAND(YAJP_BIND_EACH_20(f, __VA_ARGS__))
+#define YAJP_BIND_EACH_22(f, x, ...) f(x), YAJP_BIND_EXPAND(YAJP_BIND_EACH_21(f, __VA_ARGS__))
+#define YAJP_BIND_EACH_23(f, x, ...) f(x), YAJP_BIND_EXPAND(YAJP_BIND_EACH_22(f, __VA_ARGS__))
+#define YAJP_BIND_EACH_24(f, x, ...) f(x), YAJP_BIND_EXPAND(YAJP_BIND_EACH_23(f, __VA_ARGS__))
+#define YAJP_BIND_EACH_25(f, x, ...) f(x), YAJP_BIND_EXPAND(YAJP_BIND_EACH_24(f, __VA_ARGS__))
+#define YAJP_BIND_EACH_26(f, x, ...) f(x), YAJP_BIND_EXPAND(YAJP_BIND_EACH_25(f, __VA_ARGS__))
+#define YAJP_BIND_EACH_27(f, x, ...) f(x), YAJP_BIND_EXPAND(YAJP_BIND_EACH_26(f, __VA_ARGS__))
+#define YAJP_BIND_EACH_28(f, x, ...) f(x), YAJP_BIND_EXPAND(YAJP_BIND_EACH_27(f, __VA_ARGS__))
+#define YAJP_BIND_EACH_29(f, x, ...) f(x), YAJP_BIND_EXPAND(YAJP_BIND_EACH_28(f, __VA_ARGS__))
+#define YAJP_BIND_EACH_30(f, x, ...) f(x), YAJP_BIND_EXPAND(YAJP_BIND_EACH_29(f, __VA_ARGS__))
+#define YAJP_BIND_EACH_31(f, x, ...) f(x), YAJP_BIND_EXPAND(YAJP_BIND_EACH_30(f, __VA_ARGS__))
+#define YAJP_BIND_EACH_32(f, x, ...) f(x), YAJP_BIND_EXPAND(YAJP_BIND_EACH_31(f, __VA_ARGS__))
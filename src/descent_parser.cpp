@@ -0,0 +1,183 @@
+#include "descent_parser.h"
+#include "parser.h"
+#include "number.h"
+#include "unescape.h"
+#include <string_view>
+
+namespace yajp
+{
+
+namespace
+{
+
+std::string_view contents(const Token& token)
+{
+    return token.value().substr(1, token.value().size() - 2);
+}
+
+[[noreturn]] void invalid()
+{
+    throw ParserError("Invalid JSON");
+}
+
+}
+
+Value DescentParser::parse(Tokenizer& tokenizer)
+{
+    Value root;
+    Value* slot = &root;
+    Token token = tokenizer.next();
+    try
+    {
+        while (true)
+        {
+            // `token` starts the value which goes into `slot`
+            if (token.type() == Token::Type::LeftBracket)
+            {
+                Value::Array& array = (*slot = Value::Array(_resource)).get<Value::Array>();
+                token = tokenizer.next();
+                if (token.type() != Token::Type::RightBracket)
+                {
+                    _stack.push_back(slot);
+                    slot = &array.emplace_back();
+                    continue;
+                }
+            }
+            else if (token.type() == Token::Type::LeftBrace)
+            {
+                Value::Object& object = (*slot = Value::Object(_resource)).get<Value::Object>();
+                token = tokenizer.next();
+                if (token.type() != Token::Type::RightBrace)
+                {
+                    _stack.push_back(slot);
+                    slot = member(tokenizer, token, object);
+                    token = tokenizer.next();
+                    continue;
+                }
+            }
+            else
+            {
+                scalar(token, *slot);
+            }
+
+            // the value is complete, continue with the next member of the innermost container
+            // or close it
+            while (!_stack.empty())
+            {
+                token = tokenizer.next();
+                Value& container = *_stack.back();
+                bool object = container.type() == Value::Type::Object;
+                if (token.type() == Token::Type::Comma)
+                {
+                    token = tokenizer.next();
+                    if (object)
+                    {
+                        slot = member(tokenizer, token, container.get<Value::Object>());
+                        token = tokenizer.next();
+                    }
+                    else
+                    {
+                        slot = &container.get<Value::Array>().emplace_back();
+                    }
+                    break;
+                }
+                if (token.type() != (object ? Token::Type::RightBrace : Token::Type::RightBracket))
+                {
+                    invalid();
+                }
+                _stack.pop_back();
+            }
+            if (_stack.empty())
+            {
+                break;
+            }
+        }
+        if (tokenizer.next().type() != Token::Type::End)
+        {
+            invalid();
+        }
+    }
+    catch (...)
+    {
+        _stack.clear();
+        _discarded.clear();
+        throw;
+    }
+    // nothing may reference the memory resource once the tree is returned
+    _discarded.clear();
+    return root;
+}
+
+void DescentParser::scalar(const Token& token, Value& slot)
+{
+    switch (token.type())
+    {
+    case Token::Type::String: {
+        std::string_view string = contents(token);
+        if (!has_escapes(string))
+        {
+            slot = Value::String(string, _resource);
+            return;
+        }
+        Value::String& decoded = (slot = Value::String(_resource)).get<Value::String>();
+        append_unescaped(decoded, string);
+        return;
+    }
+    case Token::Type::Number: {
+        NumberParser::Result number = NumberParser::parse(token.value());
+        switch (number.kind)
+        {
+        case NumberParser::Kind::Integer:
+            if (_integers)
+            {
+                slot = number.integer;
+            }
+            else
+            {
+                slot = number.number;
+            }
+            return;
+        case NumberParser::Kind::Double:
+            slot = number.number;
+            return;
+        default:
+            invalid();
+        }
+    }
+    case Token::Type::KeywordTrue:
+        slot = true;
+        return;
+    case Token::Type::KeywordFalse:
+        slot = false;
+        return;
+    case Token::Type::KeywordNull:
+        slot = nullptr;
+        return;
+    default:
+        invalid();
+    }
+}
+
+// Reads the colon after `key`, returns the slot for the member's value.
+Value* DescentParser::member(Tokenizer& tokenizer, const Token& key, Value::Object& object)
+{
+    if (key.type() != Token::Type::String || tokenizer.next().type() != Token::Type::Colon)
+    {
+        invalid();
+    }
+    std::string_view name = contents(key);
+    if (has_escapes(name))
+    {
+        _key_buffer.clear();
+        append_unescaped(_key_buffer, name);
+        name = _key_buffer;
+    }
+    auto [position, inserted] = object.emplace(name);
+    if (!inserted)
+    {
+        return &_discarded.emplace_back();
+    }
+    return &position->second;
+}
+
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include "value.h"
+#include "tokenizer.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory_resource>
+
+namespace yajp
+{
+
+// The second engine behind Parser::parse, see Parser::Options::engine. Rather than reporting
+// tokens to a builder through the Reader's state machine, it follows the grammar in its own
+// control flow and constructs every value in the slot its container's insert returned, so no
+// value is moved after it is built. Open containers are kept on an explicit stack instead of
+// the call stack, so deeply nested documents are no more of a problem than for the Reader.
+class DescentParser
+{
+  public:
+    DescentParser() = default;
+
+    // Same meaning as for ValueBuilder::reset, keys never need copying since the whole input
+    // is available.
+    void reset(
+        bool integers, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+    {
+        _stack.clear();
+        _integers = integers;
+        _resource = resource;
+    }
+
+    // Parses the tokenizer's whole input. Throws ParserError if it is not a single JSON value.
+    Value parse(Tokenizer& tokenizer);
+
+  private:
+    // The innermost open container is at the back, each one is a slot of its parent.
+    std::vector<Value*> _stack;
+    std::string _key_buffer;
+    // Slots for the values of repeated keys, which are parsed and dropped since the first
+    // member wins. References to a deque's elements survive growing it.
+    std::deque<Value> _discarded;
+    bool _integers = false;
+    std::pmr::memory_resource* _resource = std::pmr::get_default_resource();
+
+    void scalar(const Token& token, Value& slot);
+    Value* member(Tokenizer& tokenizer, const Token& key, Value::Object& object);
+};
+
+}
@@ -0,0 +1,76 @@
+#include "document.h"
+#include <new>
+
+namespace yajp
+{
+
+Document::Document() : Document(0)
+{}
+
+Document::Document(std::size_t initial_size)
+    : _overflow(std::make_unique<Overflow>()), _buffer(), _buffer_size(0), _arena(), _root()
+{
+    if (initial_size != 0)
+    {
+        _buffer.reset(new std::byte[initial_size]);
+        _buffer_size = initial_size;
+    }
+    create_arena();
+    create_root();
+}
+
+void Document::clear()
+{
+    _arena->release();
+    if (_overflow->allocated() != 0)
+    {
+        // The blocks the arena added grow geometrically, their sum is a fair estimate of what
+        // the next tree of this kind needs.
+        _buffer_size += _overflow->allocated();
+        _overflow->reset();
+        _arena.reset();
+        _buffer.reset(new std::byte[_buffer_size]);
+        create_arena();
+    }
+    create_root();
+}
+
+void Document::create_arena()
+{
+    if (_buffer)
+    {
+        _arena = std::make_unique<std::pmr::monotonic_buffer_resource>(
+            _buffer.get(), _buffer_size, _overflow.get());
+    }
+    else
+    {
+        _arena = std::make_unique<std::pmr::monotonic_buffer_resource>(_overflow.get());
+    }
+#if defined(YAJP_STATS)
+    _counted = std::make_unique<stats::CountingResource>(_arena.get());
+#endif
+}
+
+void Document::create_root()
+{
+    _root = new (_arena->allocate(sizeof(Value), alignof(Value))) Value();
+}
+
+void* Document::Overflow::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    void* pointer = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    _allocated += bytes;
+    return pointer;
+}
+
+void Document::Overflow::do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment)
+{
+    std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+}
+
+bool Document::Overflow::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include "value.h"
+#include "stats.h"
+#include <memory>
+#include <memory_resource>
+#include <cstddef>
+
+namespace yajp
+{
+
+// A Value tree whose nodes, strings and array buffers all live in one arena owned by the
+// document. Destroying or clearing the document releases the arena in one step, without
+// walking the tree.
+//
+// Since the tree is never destroyed node by node, values added to it by hand have to be created
+// with resource(), anything allocated elsewhere would leak.
+//
+// The arena's memory is kept when the document is cleared, so a document which is reused for
+// trees of similar size stops allocating after the first one.
+class Document
+{
+  public:
+    Document();
+    // Reserves `initial_size` bytes for the arena up front.
+    explicit Document(std::size_t initial_size);
+
+    Document(const Document&) = delete;
+    Document& operator=(const Document&) = delete;
+    Document(Document&&) = default;
+    Document& operator=(Document&&) = default;
+
+    Value& root() { return *_root; }
+    const Value& root() const { return *_root; }
+
+    std::pmr::memory_resource* resource()
+    {
+#if defined(YAJP_STATS)
+        return _counted.get();
+#else
+        return _arena.get();
+#endif
+    }
+
+    // Drops the tree and rewinds the arena. If the tree outgrew the arena's buffer, the buffer
+    // is replaced by one large enough for all of it.
+    void clear();
+
+  private:
+    // Upstream of the arena, counts what it allocates once the buffer is exhausted.
+    class Overflow : public std::pmr::memory_resource
+    {
+      public:
+        std::size_t allocated() const { return _allocated; }
+        void reset() { _allocated = 0; }
+
+      private:
+        std::size_t _allocated = 0;
+
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+    };
+
+    // Behind pointers so that their addresses survive moving the document.
+    std::unique_ptr<Overflow> _overflow;
+    std::unique_ptr<std::byte[]> _buffer;
+    std::size_t _buffer_size;
+    std::unique_ptr<std::pmr::monotonic_buffer_resource> _arena;
+#if defined(YAJP_STATS)
+    // Counts the tree's allocations for ParseStats.
+    std::unique_ptr<stats::CountingResource> _counted;
+#endif
+    // Allocated in the arena and never destroyed.
+    Value* _root;
+
+    void create_arena();
+    void create_root();
+};
+
+}
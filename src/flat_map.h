@@ -0,0 +1,204 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <tuple>
+#include <functional>
+#include <initializer_list>
+#include <memory_resource>
+#include <stdexcept>
+#include <cstddef>
+#include <cstdint>
+
+namespace yajp
+{
+
+// String keyed map which keeps its members contiguous and in insertion order. Small maps are
+// searched linearly, larger ones additionally keep an open addressing hash index. Lookups take
+// std::string_view and never allocate.
+//
+// Keys must not be modified through iterators, since the index would not notice.
+template <typename Mapped>
+class FlatMap
+{
+  public:
+    using key_type = std::pmr::string;
+    using mapped_type = Mapped;
+    using value_type = std::pair<key_type, mapped_type>;
+    using allocator_type = std::pmr::polymorphic_allocator<value_type>;
+    using size_type = std::size_t;
+    using iterator = typename std::pmr::vector<value_type>::iterator;
+    using const_iterator = typename std::pmr::vector<value_type>::const_iterator;
+
+    // Maps with at least this many members are indexed.
+    static constexpr size_type IndexThreshold = 16;
+
+    FlatMap() = default;
+
+    explicit FlatMap(std::pmr::memory_resource* resource) : _entries(resource), _index(resource)
+    {}
+
+    FlatMap(std::initializer_list<value_type> members)
+    {
+        reserve(members.size());
+        for (const auto& [key, value] : members)
+        {
+            emplace(key, value);
+        }
+    }
+
+    FlatMap(const FlatMap&) = default;
+    FlatMap(FlatMap&&) = default;
+    FlatMap& operator=(const FlatMap&) = default;
+    FlatMap& operator=(FlatMap&&) = default;
+
+    allocator_type get_allocator() const { return _entries.get_allocator(); }
+
+    iterator begin() { return _entries.begin(); }
+    iterator end() { return _entries.end(); }
+    const_iterator begin() const { return _entries.begin(); }
+    const_iterator end() const { return _entries.end(); }
+
+    size_type size() const { return _entries.size(); }
+    bool empty() const { return _entries.empty(); }
+
+    void reserve(size_type size) { _entries.reserve(size); }
+
+    void clear()
+    {
+        _entries.clear();
+        _index.clear();
+    }
+
+    iterator find(std::string_view key) { return begin() + position(key); }
+    const_iterator find(std::string_view key) const { return begin() + position(key); }
+
+    size_type count(std::string_view key) const { return position(key) != size() ? 1 : 0; }
+    bool contains(std::string_view key) const { return position(key) != size(); }
+
+    mapped_type& at(std::string_view key)
+    {
+        size_type i = position(key);
+        if (i == size())
+        {
+            throw std::out_of_range("FlatMap::at");
+        }
+        return _entries[i].second;
+    }
+
+    const mapped_type& at(std::string_view key) const
+    {
+        size_type i = position(key);
+        if (i == size())
+        {
+            throw std::out_of_range("FlatMap::at");
+        }
+        return _entries[i].second;
+    }
+
+    mapped_type& operator[](std::string_view key) { return emplace(key).first->second; }
+
+    // Like std::map::emplace, an existing member is kept and returned.
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(std::string_view key, Args&&... args)
+    {
+        size_type i = position(key);
+        if (i != size())
+        {
+            return {begin() + i, false};
+        }
+        _entries.emplace_back(
+            std::piecewise_construct,
+            std::forward_as_tuple(key),
+            std::forward_as_tuple(std::forward<Args>(args)...));
+        if (!_index.empty() && _entries.size() * 2 <= _index.size())
+        {
+            insert_index(_entries.size() - 1);
+        }
+        else if (_entries.size() >= IndexThreshold)
+        {
+            rebuild_index();
+        }
+        return {end() - 1, true};
+    }
+
+    size_type erase(std::string_view key)
+    {
+        size_type i = position(key);
+        if (i == size())
+        {
+            return 0;
+        }
+        _entries.erase(begin() + i);
+        if (_entries.size() >= IndexThreshold)
+        {
+            rebuild_index();
+        }
+        else
+        {
+            _index.clear();
+        }
+        return 1;
+    }
+
+  private:
+    std::pmr::vector<value_type> _entries;
+    // Slots hold member positions plus one, zero marks an empty slot. The size is a power of
+    // two and at least twice the number of members.
+    std::pmr::vector<std::uint32_t> _index;
+
+    static std::size_t hash(std::string_view key) { return std::hash<std::string_view>()(key); }
+
+    // Returns size() if the key is not present.
+    size_type position(std::string_view key) const
+    {
+        if (_index.empty())
+        {
+            for (size_type i = 0; i < _entries.size(); i++)
+            {
+                if (_entries[i].first == key)
+                {
+                    return i;
+                }
+            }
+            return size();
+        }
+        size_type mask = _index.size() - 1;
+        for (size_type slot = hash(key) & mask; _index[slot] != 0; slot = (slot + 1) & mask)
+        {
+            if (_entries[_index[slot] - 1].first == key)
+            {
+                return _index[slot] - 1;
+            }
+        }
+        return size();
+    }
+
+    void insert_index(size_type i)
+    {
+        size_type mask = _index.size() - 1;
+        size_type slot = hash(_entries[i].first) & mask;
+        while (_index[slot] != 0)
+        {
+            slot = (slot + 1) & mask;
+        }
+        _index[slot] = static_cast<std::uint32_t>(i + 1);
+    }
+
+    void rebuild_index()
+    {
+        size_type slots = IndexThreshold * 2;
+        while (slots < _entries.size() * 4)
+        {
+            slots *= 2;
+        }
+        _index.assign(slots, 0);
+        for (size_type i = 0; i < _entries.size(); i++)
+        {
+            insert_index(i);
+        }
+    }
+};
+
+}
@@ -0,0 +1,78 @@
+#include "key_table.h"
+#include <functional>
+
+namespace yajp
+{
+
+std::uint32_t KeyTable::intern(std::string_view key)
+{
+    std::size_t hash = std::hash<std::string_view>()(key);
+    std::size_t i = _index.empty() ? 0 : slot(key, hash);
+    if (!_index.empty() && _index[i] != 0)
+    {
+        return _index[i] - 1;
+    }
+    if (_keys.size() >= _max_keys || key.size() > _max_bytes - _bytes)
+    {
+        return Missing;
+    }
+    // a full table is not grown any further by keys it turns away
+    if ((_keys.size() + 1) * 2 > _index.size())
+    {
+        grow();
+        i = slot(key, hash);
+    }
+    _bytes += key.size();
+    _keys.emplace_back(key);
+    _hashes.push_back(hash);
+    _index[i] = static_cast<std::uint32_t>(_keys.size());
+    return _index[i] - 1;
+}
+
+std::uint32_t KeyTable::find(std::string_view key) const
+{
+    if (_index.empty())
+    {
+        return Missing;
+    }
+    std::size_t i = slot(key, std::hash<std::string_view>()(key));
+    return _index[i] == 0 ? Missing : _index[i] - 1;
+}
+
+void KeyTable::clear()
+{
+    _keys.clear();
+    _hashes.clear();
+    _index.clear();
+    _bytes = 0;
+}
+
+std::size_t KeyTable::slot(std::string_view key, std::size_t hash) const
+{
+    std::size_t mask = _index.size() - 1;
+    std::size_t i = hash & mask;
+    // comparing the stored hashes first skips most string comparisons on collisions
+    while (_index[i] != 0 && (_hashes[_index[i] - 1] != hash || _keys[_index[i] - 1] != key))
+    {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+void KeyTable::grow()
+{
+    std::size_t slots = _index.empty() ? 64 : _index.size() * 2;
+    _index.assign(slots, 0);
+    std::size_t mask = slots - 1;
+    for (std::size_t id = 0; id < _keys.size(); id++)
+    {
+        std::size_t i = _hashes[id] & mask;
+        while (_index[i] != 0)
+        {
+            i = (i + 1) & mask;
+        }
+        _index[i] = static_cast<std::uint32_t>(id + 1);
+    }
+}
+
+}
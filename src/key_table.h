@@ -0,0 +1,71 @@
+#pragma once
+#include <deque>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+
+namespace yajp
+{
+
+// Intern table for object keys, see Parser::Options::keys. Every distinct key is stored once
+// and numbered in order of first appearance, TapeDocuments parsed against the table hold only
+// the numbers. Keys are found through an open addressing hash index.
+//
+// The table only grows up to a number of keys and bytes of key text, so input with ever new
+// keys cannot make it grow without bound. Keys which do not fit anymore are stored in each
+// document like without a table.
+//
+// A table is not synchronized: share it between the parsers of one thread, or give each parser
+// its own. Documents referring to it may be read while no parser adds keys.
+class KeyTable
+{
+  public:
+    // Returned by intern() for new keys which do not fit, and by find() for keys which were
+    // never added.
+    static constexpr std::uint32_t Missing = UINT32_MAX;
+
+    static constexpr std::size_t DefaultMaxKeys = 4096;
+    static constexpr std::size_t DefaultMaxBytes = 256 * 1024;
+
+    explicit KeyTable(
+        std::size_t max_keys = DefaultMaxKeys, std::size_t max_bytes = DefaultMaxBytes)
+        : _max_keys(max_keys), _max_bytes(max_bytes)
+    {}
+
+    KeyTable(const KeyTable&) = delete;
+    KeyTable& operator=(const KeyTable&) = delete;
+
+    // Returns the key's number, adding the key if it is new and fits.
+    std::uint32_t intern(std::string_view key);
+    std::uint32_t find(std::string_view key) const;
+
+    // Views stay valid until the table is cleared or destroyed.
+    std::string_view key(std::uint32_t id) const { return _keys[id]; }
+
+    std::size_t size() const { return _keys.size(); }
+    // Bytes of key text stored.
+    std::size_t bytes() const { return _bytes; }
+
+    // Removes every key, for instance once the table is full of keys which are not used
+    // anymore. Documents parsed against the table must not be used afterwards.
+    void clear();
+
+  private:
+    std::size_t _max_keys;
+    std::size_t _max_bytes;
+    std::size_t _bytes = 0;
+    // Elements of a deque do not move when it grows.
+    std::deque<std::string> _keys;
+    std::vector<std::size_t> _hashes;
+    // Slots hold key numbers plus one, zero marks an empty slot. The size is a power of two and
+    // at least twice the number of keys.
+    std::vector<std::uint32_t> _index;
+
+    // Returns the slot holding the key, or the empty slot it would go into.
+    std::size_t slot(std::string_view key, std::size_t hash) const;
+    void grow();
+};
+
+}
@@ -0,0 +1,302 @@
+#include "lazy.h"
+#include "parser.h"
+#include "reader.h"
+#include "value_builder.h"
+#include "number.h"
+#include "unescape.h"
+#include <stdexcept>
+#include <utility>
+
+namespace yajp
+{
+
+LazyDocument::LazyDocument(const std::string& input, bool integers, bool validate_utf8)
+    : _tokenizer(input, validate_utf8), _integers(integers)
+{
+    check_size();
+}
+
+LazyDocument::LazyDocument(std::string&& input, bool integers, bool validate_utf8)
+    : _tokenizer(std::move(input), validate_utf8), _integers(integers)
+{
+    check_size();
+}
+
+LazyValue LazyDocument::root() const
+{
+    return LazyValue(this, 0);
+}
+
+Value LazyDocument::materialize() const
+{
+    // anything after the root value is an error as well
+    if (skip(0) != size())
+    {
+        throw ParserError("Invalid JSON");
+    }
+    return materialize(0);
+}
+
+void LazyDocument::check_size() const
+{
+    if (_tokenizer.input().size() > StructuralIndex::MaxInputSize)
+    {
+        throw ParserError("Input too large for on-demand parsing");
+    }
+    if (!_tokenizer.valid_utf8())
+    {
+        throw ParserError("Invalid UTF-8");
+    }
+}
+
+char LazyDocument::at(std::size_t i) const
+{
+    if (i >= size())
+    {
+        throw ParserError("Invalid JSON");
+    }
+    return _tokenizer.input()[_tokenizer.index()[i]];
+}
+
+std::size_t LazyDocument::skip(std::size_t i) const
+{
+    char c = at(i);
+    // every other token is a single run of bytes with one index position
+    return c == '{' || c == '[' ? close(i + 1) : i + 1;
+}
+
+std::size_t LazyDocument::close(std::size_t i) const
+{
+    std::string_view input = _tokenizer.input();
+    const StructuralIndex& index = _tokenizer.index();
+    std::size_t depth = 1;
+    for (; i < index.size(); i++)
+    {
+        switch (input[index[i]])
+        {
+        case '{':
+        case '[':
+            depth++;
+            break;
+        case '}':
+        case ']':
+            if (--depth == 0)
+            {
+                return i + 1;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    throw ParserError("Invalid JSON");
+}
+
+Token LazyDocument::token(std::size_t i) const
+{
+    at(i);
+    _tokenizer.seek(_tokenizer.index()[i]);
+    Token token = _tokenizer.next();
+    if (token.type() == Token::Type::Invalid)
+    {
+        throw ParserError("Invalid JSON");
+    }
+    return token;
+}
+
+Value LazyDocument::materialize(std::size_t i) const
+{
+    at(i);
+    _tokenizer.seek(_tokenizer.index()[i]);
+    Reader reader;
+    ValueBuilder builder;
+    builder.reset(_integers, false);
+    while (!reader.done())
+    {
+        reader.consume(_tokenizer.next(), builder);
+        if (reader.failed())
+        {
+            throw ParserError("Invalid JSON");
+        }
+    }
+    return builder.take();
+}
+
+Value::Type LazyValue::type() const
+{
+    switch (_document->at(_position))
+    {
+    case '{':
+        return Value::Type::Object;
+    case '[':
+        return Value::Type::Array;
+    case '"':
+        return Value::Type::String;
+    case 't':
+    case 'f':
+        return Value::Type::Bool;
+    case 'n':
+        return Value::Type::Null;
+    default:
+        return Value::Type::Number;
+    }
+}
+
+bool LazyValue::is_null() const
+{
+    return _document->token(_position).type() == Token::Type::KeywordNull;
+}
+
+bool LazyValue::get_bool() const
+{
+    switch (_document->token(_position).type())
+    {
+    case Token::Type::KeywordTrue:
+        return true;
+    case Token::Type::KeywordFalse:
+        return false;
+    default:
+        throw ParserError("Value is not a bool");
+    }
+}
+
+double LazyValue::get_number() const
+{
+    Token token = _document->token(_position);
+    if (token.type() != Token::Type::Number)
+    {
+        throw ParserError("Value is not a number");
+    }
+    return NumberParser::parse(token.value()).number;
+}
+
+std::int64_t LazyValue::get_integer() const
+{
+    Token token = _document->token(_position);
+    NumberParser::Result number = NumberParser::parse(token.value());
+    if (token.type() != Token::Type::Number || number.kind != NumberParser::Kind::Integer)
+    {
+        throw ParserError("Value is not an integer");
+    }
+    return number.integer;
+}
+
+Value::String LazyValue::get_string() const
+{
+    Token token = _document->token(_position);
+    if (token.type() != Token::Type::String)
+    {
+        throw ParserError("Value is not a string");
+    }
+    Value::String string;
+    append_unescaped(string, token.value().substr(1, token.value().size() - 2));
+    return string;
+}
+
+std::optional<LazyValue> LazyValue::find(std::string_view key) const
+{
+    std::string buffer;
+    for (std::size_t i = first('{'); _document->at(i) != '}'; i = advance(i + 2, '}'))
+    {
+        if (this->key(i, buffer) == key)
+        {
+            return LazyValue(_document, i + 2);
+        }
+    }
+    return std::nullopt;
+}
+
+LazyValue LazyValue::operator[](std::string_view key) const
+{
+    std::optional<LazyValue> value = find(key);
+    if (!value)
+    {
+        throw std::out_of_range("LazyValue::operator[]");
+    }
+    return *value;
+}
+
+LazyValue LazyValue::operator[](std::size_t index) const
+{
+    for (std::size_t i = first('['); _document->at(i) != ']'; i = advance(i, ']'))
+    {
+        if (index-- == 0)
+        {
+            return LazyValue(_document, i);
+        }
+    }
+    throw std::out_of_range("LazyValue::operator[]");
+}
+
+std::size_t LazyValue::size() const
+{
+    std::size_t count = 0;
+    if (type() == Value::Type::Array)
+    {
+        for (std::size_t i = first('['); _document->at(i) != ']'; i = advance(i, ']'))
+        {
+            count++;
+        }
+        return count;
+    }
+    for (std::size_t i = first('{'); _document->at(i) != '}'; i = advance(i + 2, '}'))
+    {
+        count++;
+    }
+    return count;
+}
+
+std::size_t LazyValue::first(char open) const
+{
+    if (_document->at(_position) != open)
+    {
+        throw ParserError(open == '{' ? "Value is not an object" : "Value is not an array");
+    }
+    std::size_t i = _position + 1;
+    char c = _document->at(i);
+    if (open == '{' && c != '}' && (c != '"' || _document->at(i + 1) != ':'))
+    {
+        throw ParserError("Invalid JSON");
+    }
+    return i;
+}
+
+std::size_t LazyValue::advance(std::size_t i, char close) const
+{
+    return separator(_document->skip(i), close);
+}
+
+std::size_t LazyValue::separator(std::size_t i, char close) const
+{
+    char c = _document->at(i);
+    if (c == close)
+    {
+        return i;
+    }
+    if (c != ',')
+    {
+        throw ParserError("Invalid JSON");
+    }
+    i++;
+    c = _document->at(i);
+    if (close == ']' ? c == ']' : (c != '"' || _document->at(i + 1) != ':'))
+    {
+        throw ParserError("Invalid JSON");
+    }
+    return i;
+}
+
+std::string_view LazyValue::key(std::size_t i, std::string& buffer) const
+{
+    std::string_view key = _document->token(i).value();
+    key = key.substr(1, key.size() - 2);
+    if (!has_escapes(key))
+    {
+        return key;
+    }
+    buffer.clear();
+    append_unescaped(buffer, key);
+    return buffer;
+}
+
+}
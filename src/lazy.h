@@ -0,0 +1,133 @@
+#pragma once
+#include "value.h"
+#include "tokenizer.h"
+#include <string>
+#include <string_view>
+#include <optional>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace yajp
+{
+
+class LazyValue;
+
+// On-demand view of a document, returned by Parser::parse_lazy. Only the structural index is
+// built up front. Values are located by walking the index when they are reached, subtrees which
+// are passed over are skipped by bracket matching, without building values or converting
+// numbers. Consequently only the parts of the document which are accessed are validated,
+// errors are reported as ParserError by the access which reaches them.
+//
+// The document is not thread safe, and its values are valid while it is.
+class LazyDocument
+{
+  public:
+    // The input is referenced, not copied, and has to outlive the document. UTF-8 validation
+    // covers the whole input, since it runs while the index is built.
+    LazyDocument(const std::string& input, bool integers, bool validate_utf8 = false);
+    LazyDocument(std::string&& input, bool integers, bool validate_utf8 = false);
+
+    LazyDocument(const LazyDocument&) = delete;
+    LazyDocument& operator=(const LazyDocument&) = delete;
+
+    LazyValue root() const;
+    // Builds the whole document, validating all of it.
+    Value materialize() const;
+
+  private:
+    friend class LazyValue;
+    friend class Query;
+
+    mutable Tokenizer _tokenizer;
+    bool _integers;
+
+    void check_size() const;
+    std::size_t size() const { return _tokenizer.index().size(); }
+    // The first byte of the token at index position `i`, throws if there is none.
+    char at(std::size_t i) const;
+    // Index position of the token after the value at index position `i`.
+    std::size_t skip(std::size_t i) const;
+    // Index position after the closing bracket of the container whose contents start at `i`.
+    std::size_t close(std::size_t i) const;
+    Token token(std::size_t i) const;
+    Value materialize(std::size_t i) const;
+};
+
+// Handle to one value of a LazyDocument, cheap to copy.
+class LazyValue
+{
+  public:
+    // Value::Type::Number for all numbers.
+    Value::Type type() const;
+
+    bool is_null() const;
+    // These throw ParserError if the value is malformed or has another type.
+    bool get_bool() const;
+    double get_number() const;
+    // Only for integers which fit into 64 bits.
+    std::int64_t get_integer() const;
+    Value::String get_string() const;
+
+    // Object member lookup, members before the match are skipped.
+    std::optional<LazyValue> find(std::string_view key) const;
+    // Throws std::out_of_range if there is no such member or element.
+    LazyValue operator[](std::string_view key) const;
+    LazyValue operator[](std::size_t index) const;
+
+    // Number of members or elements, walks over them.
+    std::size_t size() const;
+
+    // Calls `function(LazyValue)` for every array element, or `function(std::string_view key,
+    // LazyValue)` for every object member, throws ParserError if the value is not an array or
+    // an object respectively. Keys are decoded, and only valid during the call.
+    template <typename Function>
+    void for_each(Function function) const;
+
+    // Builds a Value out of this value and everything it contains.
+    Value materialize() const { return _document->materialize(_position); }
+
+  private:
+    friend class LazyDocument;
+    friend class Query;
+
+    const LazyDocument* _document;
+    // Position in the structural index.
+    std::size_t _position;
+
+    LazyValue(const LazyDocument* document, std::size_t position)
+        : _document(document), _position(position)
+    {}
+
+    // Index position of the first member key or element, or of the closing bracket.
+    std::size_t first(char open) const;
+    // Index position of the next member key or element after the value at `i`, or of the
+    // closing bracket.
+    std::size_t advance(std::size_t i, char close) const;
+    // Same as advance, with `i` the index position right after the value.
+    std::size_t separator(std::size_t i, char close) const;
+    // The decoded key at index position `i`, `buffer` holds it if it had to be decoded.
+    std::string_view key(std::size_t i, std::string& buffer) const;
+};
+
+template <typename Function>
+void LazyValue::for_each(Function function) const
+{
+    if constexpr (std::is_invocable_v<Function&, LazyValue>)
+    {
+        for (std::size_t i = first('['); _document->at(i) != ']'; i = advance(i, ']'))
+        {
+            function(LazyValue(_document, i));
+        }
+    }
+    else
+    {
+        std::string buffer;
+        for (std::size_t i = first('{'); _document->at(i) != '}'; i = advance(i + 2, '}'))
+        {
+            function(key(i, buffer), LazyValue(_document, i + 2));
+        }
+    }
+}
+
+}
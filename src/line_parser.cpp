@@ -0,0 +1,254 @@
+#include "line_parser.h"
+#include "tokenizer.h"
+#include "reader.h"
+#include "value_builder.h"
+#include "utf8.h"
+#include <string_view>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <algorithm>
+#include <utility>
+
+namespace yajp
+{
+
+namespace
+{
+
+struct Chunk
+{
+    std::string_view text;
+    std::vector<Value> values;
+    // Line of each value, relative to the start of the chunk and starting at 0.
+    std::vector<std::size_t> lines;
+    // Number of line breaks in the chunk, only complete if there is no error.
+    std::size_t breaks = 0;
+    const char* error = nullptr;
+    std::exception_ptr exception;
+    bool ready = false;
+};
+
+std::vector<Chunk> split(std::string_view input, std::size_t chunk_size)
+{
+    std::vector<Chunk> chunks;
+    chunk_size = std::max<std::size_t>(chunk_size, 1);
+    while (!input.empty())
+    {
+        // each chunk ends with its last line break, so the byte after it is never part of a token
+        std::size_t end = chunk_size < input.size() ? input.find('\n', chunk_size) : input.npos;
+        end = end == input.npos ? input.size() : end + 1;
+        chunks.emplace_back().text = input.substr(0, end);
+        input.remove_prefix(end);
+    }
+    return chunks;
+}
+
+void parse_invalid_chunk(Chunk& chunk, bool integers);
+
+void parse_chunk(Chunk& chunk, bool integers, bool validate_utf8)
+{
+    Tokenizer tokenizer(chunk.text, validate_utf8);
+    if (!tokenizer.valid_utf8())
+    {
+        parse_invalid_chunk(chunk, integers);
+        return;
+    }
+    Reader reader;
+    ValueBuilder builder;
+    builder.reset(integers, false);
+    const char* last = chunk.text.data();
+    std::size_t line = 0;
+    // Line of the previous value, so a second value on it can be detected.
+    std::size_t value_line = chunk.text.npos;
+    while (true)
+    {
+        Token token = tokenizer.next();
+        bool end = token.type() == Token::Type::End;
+        const char* first = end ? chunk.text.data() + chunk.text.size() : token.value().data();
+        // only the whitespace between tokens can contain line breaks
+        std::size_t breaks = std::count(last, first, '\n');
+        if (breaks != 0 && reader.state() != Reader::State::Initial)
+        {
+            chunk.error = "Value spans several lines";
+            break;
+        }
+        line += breaks;
+        if (end)
+        {
+            break;
+        }
+        if (reader.state() == Reader::State::Initial && line == value_line)
+        {
+            chunk.error = "Several values on one line";
+            break;
+        }
+        reader.consume(token, builder);
+        if (reader.failed())
+        {
+            chunk.error = "Invalid JSON";
+            break;
+        }
+        last = first + token.value().size();
+        if (reader.done())
+        {
+            chunk.values.push_back(builder.take());
+            chunk.lines.push_back(line);
+            value_line = line;
+            reader.reset();
+            builder.reset(integers, false);
+        }
+    }
+    if (chunk.error == nullptr && reader.state() != Reader::State::Initial)
+    {
+        chunk.error = "Invalid JSON";
+    }
+    chunk.breaks = line;
+}
+
+// Slow path for chunks which are not UTF-8, the lines before the first invalid one are parsed
+// as usual. Sequences never contain line breaks, so lines can be checked one by one.
+void parse_invalid_chunk(Chunk& chunk, bool integers)
+{
+    std::string_view text = chunk.text;
+    std::size_t offset = 0;
+    std::size_t line = 0;
+    while (true)
+    {
+        std::size_t end = text.find('\n', offset);
+        end = end == text.npos ? text.size() : end + 1;
+        if (!is_valid_utf8(text.substr(offset, end - offset)))
+        {
+            break;
+        }
+        offset = end;
+        line++;
+    }
+    chunk.text = text.substr(0, offset);
+    parse_chunk(chunk, integers, false);
+    if (chunk.error == nullptr)
+    {
+        chunk.error = "Invalid UTF-8";
+        chunk.breaks = line;
+    }
+}
+
+}
+
+LineParser::LineParser(const Options& options) : _options(options)
+{}
+
+std::vector<Value> LineParser::parse(const std::string& input)
+{
+    std::vector<Value> values;
+    parse(input, [&](std::size_t, Value&& value) { values.push_back(std::move(value)); });
+    return values;
+}
+
+void LineParser::parse(
+    const std::string& input,
+    const std::function<void(std::size_t line, Value&& value)>& callback)
+{
+    std::vector<Chunk> chunks = split(input, _options.chunk_size);
+    std::size_t threads = _options.threads;
+    if (threads == 0)
+    {
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    threads = std::min(threads, chunks.size());
+    // Workers may only take chunks up to this many ahead of the next one to deliver.
+    const std::size_t window = 2 * threads;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::size_t next = 0;
+    std::size_t delivered = 0;
+    bool stop = false;
+
+    auto work = [&]()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true)
+        {
+            condition.wait(
+                lock,
+                [&] { return stop || next == chunks.size() || next < delivered + window; });
+            if (stop || next == chunks.size())
+            {
+                return;
+            }
+            Chunk& chunk = chunks[next++];
+            lock.unlock();
+            try
+            {
+                parse_chunk(chunk, _options.integers, _options.validate_utf8);
+            }
+            catch (...)
+            {
+                chunk.exception = std::current_exception();
+            }
+            lock.lock();
+            chunk.ready = true;
+            condition.notify_all();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    // Stops and joins the workers however the delivery loop is left.
+    struct Join
+    {
+        std::vector<std::thread>& workers;
+        std::mutex& mutex;
+        std::condition_variable& condition;
+        bool& stop;
+
+        ~Join()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stop = true;
+            }
+            condition.notify_all();
+            for (std::thread& worker : workers)
+            {
+                worker.join();
+            }
+        }
+    } join{workers, mutex, condition, stop};
+    for (std::size_t i = 0; i < threads; i++)
+    {
+        workers.emplace_back(work);
+    }
+
+    std::size_t line = 1;
+    for (Chunk& chunk : chunks)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [&] { return chunk.ready; });
+        }
+        if (chunk.exception)
+        {
+            std::rethrow_exception(chunk.exception);
+        }
+        for (std::size_t i = 0; i < chunk.values.size(); i++)
+        {
+            callback(line + chunk.lines[i], std::move(chunk.values[i]));
+        }
+        if (chunk.error != nullptr)
+        {
+            throw LineError(line + chunk.breaks, chunk.error);
+        }
+        line += chunk.breaks;
+        chunk.values = std::vector<Value>();
+        chunk.lines = std::vector<std::size_t>();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            delivered++;
+        }
+        condition.notify_all();
+    }
+}
+
+}
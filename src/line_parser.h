@@ -0,0 +1,61 @@
+#pragma once
+#include "value.h"
+#include "parser.h"
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstddef>
+
+namespace yajp
+{
+
+// Parser for JSON Lines (newline-delimited JSON), one value per line. The input is split into
+// chunks at line boundaries which are parsed in parallel, each with a single tokenizer pass,
+// and the values are handed back in input order. Blank lines are skipped, a value which spans
+// several lines or shares its line with another one is an error.
+class LineParser
+{
+  public:
+    struct Options
+    {
+        // Store integers which fit into 64 bits as Value::Integer instead of Value::Number.
+        bool integers = false;
+        // Reject lines which are not well-formed UTF-8, checked while chunks are indexed.
+        bool validate_utf8 = false;
+        // Number of worker threads, 0 uses one per hardware thread.
+        std::size_t threads = 0;
+        // Approximate chunk size in bytes, chunks are extended to the end of their last line.
+        std::size_t chunk_size = 1 << 20;
+    };
+
+    LineParser() = default;
+    explicit LineParser(const Options& options);
+
+    // Throws LineError for the first invalid line, values before it are not returned.
+    std::vector<Value> parse(const std::string& input);
+    // Calls `callback(line, value)` on the calling thread for each value in input order, line
+    // numbers start at 1. Workers only run a few chunks ahead of the callback, so memory stays
+    // bounded. Throws LineError for the first invalid line, after all values before it have
+    // been passed to the callback.
+    void parse(
+        const std::string& input,
+        const std::function<void(std::size_t line, Value&& value)>& callback);
+
+  private:
+    Options _options;
+};
+
+class LineError : public ParserError
+{
+  public:
+    LineError(std::size_t line, const std::string& message) : ParserError(message), _line(line)
+    {}
+
+    // Starting at 1.
+    std::size_t line() const { return _line; }
+
+  private:
+    std::size_t _line;
+};
+
+}
@@ -0,0 +1,187 @@
+#include "mapped_file.h"
+#include <system_error>
+#include <utility>
+#include <cerrno>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <algorithm>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace yajp
+{
+
+#ifdef _WIN32
+
+namespace
+{
+
+[[noreturn]] void throw_last_error(const std::string& what)
+{
+    throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), what);
+}
+
+}
+
+MappedFile::MappedFile(const std::string& path)
+{
+    HANDLE file = CreateFileA(
+        path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        throw_last_error(path);
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        throw_last_error(path);
+    }
+    _size = static_cast<std::size_t>(size.QuadPart);
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    if (_size == 0)
+    {
+        CloseHandle(file);
+        return;
+    }
+    if (_size % info.dwPageSize == 0)
+    {
+        // a view ends with the file's last page, so there would be no zero byte after it
+        _buffer.resize(_size);
+        std::size_t done = 0;
+        while (done < _size)
+        {
+            DWORD chunk = static_cast<DWORD>(std::min<std::size_t>(_size - done, 1u << 30));
+            DWORD read = 0;
+            if (!ReadFile(file, _buffer.data() + done, chunk, &read, nullptr) || read == 0)
+            {
+                CloseHandle(file);
+                throw_last_error(path);
+            }
+            done += read;
+        }
+        CloseHandle(file);
+        _data = _buffer.data();
+        return;
+    }
+    // the rest of the last page after the end of the file reads as zeros
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr)
+    {
+        throw_last_error(path);
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (view == nullptr)
+    {
+        throw_last_error(path);
+    }
+    _data = static_cast<const char*>(view);
+    _mapped = _size;
+}
+
+void MappedFile::release()
+{
+    if (_mapped != 0)
+    {
+        UnmapViewOfFile(_data);
+    }
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        throw std::system_error(errno, std::generic_category(), path);
+    }
+    struct stat status;
+    if (fstat(fd, &status) == -1)
+    {
+        int error = errno;
+        close(fd);
+        throw std::system_error(error, std::generic_category(), path);
+    }
+    _size = static_cast<std::size_t>(status.st_size);
+    if (_size == 0)
+    {
+        close(fd);
+        return;
+    }
+    // Reserve the file's pages plus at least one zero byte of anonymous memory, then map the
+    // file over the start of the reservation.
+    std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    std::size_t length = (_size / page + 1) * page;
+    void* reservation = mmap(nullptr, length, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (reservation == MAP_FAILED)
+    {
+        int error = errno;
+        close(fd);
+        throw std::system_error(error, std::generic_category(), path);
+    }
+    void* data = mmap(reservation, _size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0);
+    int error = errno;
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        munmap(reservation, length);
+        throw std::system_error(error, std::generic_category(), path);
+    }
+    posix_madvise(data, _size, POSIX_MADV_SEQUENTIAL);
+    _data = static_cast<const char*>(data);
+    _mapped = length;
+}
+
+void MappedFile::release()
+{
+    if (_mapped != 0)
+    {
+        munmap(const_cast<char*>(_data), _mapped);
+    }
+}
+
+#endif
+
+MappedFile::~MappedFile()
+{
+    release();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        _size = std::exchange(other._size, 0);
+        _mapped = std::exchange(other._mapped, 0);
+        _buffer = std::move(other._buffer);
+        // a moved short string does not keep its address
+        _data = _mapped == 0 && _size != 0 ? _buffer.data() : other._data;
+        other._data = "";
+    }
+    return *this;
+}
+
+}
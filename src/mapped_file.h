@@ -0,0 +1,40 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+namespace yajp
+{
+
+// A file mapped read-only into memory, so it can be tokenized without being copied. The data
+// is always followed by at least one zero byte, like a std::string, so the tokenizer's
+// lookahead past the last token stays within the mapping. On POSIX systems the padding is an
+// anonymous page reserved after the file, on Windows files whose size is a multiple of the
+// page size are read into a buffer instead.
+class MappedFile
+{
+  public:
+    // Throws std::system_error if the file cannot be opened or mapped.
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::string_view data() const { return {_data, _size}; }
+    std::size_t size() const { return _size; }
+
+  private:
+    const char* _data = "";
+    std::size_t _size = 0;
+    // Length of the whole mapping including the padding, 0 if nothing is mapped.
+    std::size_t _mapped = 0;
+    // Fallback copy with a terminator, used where padding cannot be mapped.
+    std::string _buffer;
+
+    void release();
+};
+
+}
@@ -0,0 +1,177 @@
+#include "number.h"
+#include <charconv>
+#include <limits>
+#include <cfloat>
+
+namespace yajp
+{
+
+namespace
+{
+
+    constexpr double exact_powers[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    };
+
+    inline bool is_digit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+}
+
+NumberParser::Result NumberParser::parse(std::string_view text)
+{
+    Result result{Kind::Invalid, 0, 0.0};
+    const char* c = text.data();
+    const char* last = c + text.size();
+
+    bool negative = c != last && *c == '-';
+    if (negative)
+    {
+        c++;
+    }
+    if (c == last || !is_digit(*c))
+    {
+        return result;
+    }
+
+    // Significant digits go into the mantissa as long as they fit, the rest only count
+    // towards the scale. Leading zeros of the fraction are not significant.
+    std::uint64_t mantissa = 0;
+    int digits = 0;
+    int scale = 0;
+    bool truncated = false;
+    auto add_digit = [&](char digit) {
+        if (digits < MaxDigits)
+        {
+            mantissa = mantissa * 10 + static_cast<std::uint64_t>(digit - '0');
+            if (mantissa != 0)
+            {
+                digits++;
+            }
+            return true;
+        }
+        truncated = truncated || digit != '0';
+        return false;
+    };
+
+    if (*c == '0')
+    {
+        c++;
+        // numbers can only have a single zero at the start
+        if (c != last && is_digit(*c))
+        {
+            return result;
+        }
+    }
+    else
+    {
+        for (; c != last && is_digit(*c); c++)
+        {
+            if (!add_digit(*c))
+            {
+                scale++;
+            }
+        }
+    }
+
+    bool integral = true;
+    if (c != last && *c == '.')
+    {
+        integral = false;
+        c++;
+        if (c == last || !is_digit(*c))
+        {
+            return result;
+        }
+        for (; c != last && is_digit(*c); c++)
+        {
+            if (add_digit(*c))
+            {
+                scale--;
+            }
+        }
+    }
+
+    if (c != last && (*c == 'e' || *c == 'E'))
+    {
+        integral = false;
+        c++;
+        bool negative_exponent = false;
+        if (c != last && (*c == '-' || *c == '+'))
+        {
+            negative_exponent = *c == '-';
+            c++;
+        }
+        if (c == last || !is_digit(*c))
+        {
+            return result;
+        }
+        int exponent = 0;
+        for (; c != last && is_digit(*c); c++)
+        {
+            // anything this large is zero or infinity anyway
+            if (exponent < 100000)
+            {
+                exponent = exponent * 10 + (*c - '0');
+            }
+        }
+        scale += negative_exponent ? -exponent : exponent;
+    }
+
+    if (c != last)
+    {
+        return result;
+    }
+
+    if (integral && !truncated && scale == 0)
+    {
+        constexpr std::uint64_t max = std::numeric_limits<std::int64_t>::max();
+        if (mantissa <= max || (negative && mantissa == max + 1))
+        {
+            // -0 is kept as a double, since an integer cannot carry its sign
+            if (!(negative && mantissa == 0))
+            {
+                result.kind = Kind::Integer;
+                result.integer = negative ? static_cast<std::int64_t>(0 - mantissa)
+                                          : static_cast<std::int64_t>(mantissa);
+                result.number = static_cast<double>(result.integer);
+                return result;
+            }
+        }
+    }
+
+    result.kind = Kind::Double;
+#if !defined(FLT_EVAL_METHOD) || FLT_EVAL_METHOD == 0
+    // Clinger's fast path: both the mantissa and the power of ten are exact doubles, so a single
+    // correctly rounded operation gives the correctly rounded result.
+    if (!truncated && mantissa <= MaxExactMantissa && scale >= -MaxExactPower &&
+        scale <= MaxExactPower)
+    {
+        double value = static_cast<double>(mantissa);
+        value = scale < 0 ? value / exact_powers[-scale] : value * exact_powers[scale];
+        result.number = negative ? -value : value;
+        return result;
+    }
+#endif
+    result.number = parse_fallback(text, negative, scale + digits);
+    return result;
+}
+
+double NumberParser::parse_fallback(std::string_view text, bool negative, int scale)
+{
+    // std::from_chars is correctly rounded and does not depend on the locale.
+    double value = 0.0;
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error == std::errc::result_out_of_range)
+    {
+        // `scale` is the decimal exponent of the leading digit plus one
+        value = scale > 0 ? std::numeric_limits<double>::infinity() : 0.0;
+        return negative ? -value : value;
+    }
+    return value;
+}
+
+}
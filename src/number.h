@@ -0,0 +1,39 @@
+#pragma once
+#include <string_view>
+#include <cstdint>
+
+namespace yajp
+{
+
+// Locale independent conversion of JSON number literals.
+class NumberParser
+{
+  public:
+    enum class Kind
+    {
+        Invalid,
+        Integer,
+        Double,
+    };
+
+    struct Result
+    {
+        Kind kind;
+        std::int64_t integer;
+        double number;
+    };
+
+    // Integers without fraction or exponent that fit into 64 bits are returned exactly as
+    // Kind::Integer (`number` holds their nearest double), everything else as Kind::Double.
+    // Text which is not exactly one JSON number results in Kind::Invalid.
+    static Result parse(std::string_view text);
+
+  private:
+    static constexpr int MaxDigits = 19;
+    static constexpr int MaxExactPower = 22;
+    static constexpr std::uint64_t MaxExactMantissa = std::uint64_t(1) << 53;
+
+    static double parse_fallback(std::string_view text, bool negative, int scale);
+};
+
+}
@@ -2,422 +2,459 @@
 #include "tokenizer.h"
 #include <vector>
 #include <utility>
+#include <thread>
+#include <exception>
+#include <algorithm>
+#include <iterator>
 
 namespace yajp
 {
 
-Value Parser::parse(const std::string& string)
+namespace
 {
-    reset();
-    Tokenizer tokenizer(std::move(string));
-    std::vector<Token> tokens = tokenizer.all();
-    State state = State::Initial;
-    for (const auto& token : tokens)
-    {
-        if (token.type() == Token::Type::Invalid)
-        {
-            break;
-        }
-        consume(token);
-        if (_current_state == State::Error)
-        {
-            break;
-        }
-    }
-    if (_current_state != State::End)
-    {
-        throw ParserError("Invalid JSON");
-    }
-    return std::move(_global_value);
-}
 
-Value Parser::parse(std::string&& string)
+// Smallest slice parse_parallel picks on its own, below that threads do not pay off.
+constexpr std::size_t MinimumSliceSize = 64 * 1024;
+
+// Position of the first byte at which UTF-8 validation fails, only called for invalid input.
+std::size_t invalid_utf8_offset(std::string_view string)
 {
-    reset();
-    Tokenizer tokenizer(std::move(string));
-    std::vector<Token> tokens = tokenizer.all();
-    for (const auto& token : tokens)
+    utf8::ScalarValidator validator;
+    for (std::size_t i = 0; i < string.size(); i++)
     {
-        if (token.type() == Token::Type::Invalid)
+        validator.check(string.data() + i, 1);
+        if (validator.failed())
         {
-            break;
+            return i;
         }
-        consume(token);
-        if (_current_state == State::Error)
-        {
-            break;
-        }
-    }
-    if (_current_state != State::End)
-    {
-        throw ParserError("Invalid JSON");
     }
-    return std::move(_global_value);
+    return string.size();
 }
 
-Value Parser::parse_lazy(const std::string& string)
+// Parses `elements`, a comma separated part of a top-level array, as an array of its own.
+// The slice is followed by the comma or bracket which ends it, so it can be tokenized in place.
+Value::Array parse_slice(std::string_view elements, bool integers)
 {
-    reset();
-    Tokenizer tokenizer(std::move(string));
+    Tokenizer tokenizer(elements);
+    Reader reader;
+    ValueBuilder builder;
+    builder.reset(integers, false);
+    reader.consume(Token(Token::Type::LeftBracket, "["), builder);
     for (Token token = tokenizer.next(); token.type() != Token::Type::End; token = tokenizer.next())
     {
-        if (token.type() == Token::Type::Invalid)
+        reader.consume(token, builder);
+        if (reader.failed())
         {
-            break;
-        }
-        consume(token);
-        if (_current_state == State::Error)
-        {
-            break;
+            throw ParserError("Invalid JSON");
         }
     }
-    if (_current_state != State::End)
+    reader.consume(Token(Token::Type::RightBracket, "]"), builder);
+    Value array = builder.take();
+    // an empty slice means an element was missing between two commas
+    if (!reader.done() || array.get<Value::Array>().empty())
     {
         throw ParserError("Invalid JSON");
     }
-    return std::move(_global_value);
+    return std::move(array.get<Value::Array>());
 }
 
-Value Parser::parse_lazy(std::string&& string)
+}
+
+Parser::Parser() : _typed(_tokenizer)
 {
-    reset();
-    Tokenizer tokenizer(std::move(string));
-    for (Token token = tokenizer.next(); token.type() != Token::Type::End; token = tokenizer.next())
-    {
-        if (token.type() == Token::Type::Invalid)
-        {
-            break;
-        }
-        consume(token);
-        if (_current_state == State::Error)
-        {
-            break;
-        }
-    }
-    if (_current_state != State::End)
+    _tokenizer.set_stats(&_stats);
+}
+
+Parser::Parser(const Options& options) : _typed(_tokenizer), _options(options)
+{
+    _tokenizer.set_stats(&_stats);
+}
+
+Parser::Parser(Parser&& other) : Parser(other._options)
+{
+    *this = std::move(other);
+}
+
+Parser& Parser::operator=(Parser&& other)
+{
+    if (this != &other)
     {
-        throw ParserError("Invalid JSON");
+        // the tokenizer keeps pointing at this parser's statistics, and the typed reader at
+        // this parser's tokenizer
+        _reader = std::move(other._reader);
+        _builder = std::move(other._builder);
+        _options = std::move(other._options);
+        _stream = std::move(other._stream);
+        _streaming = other._streaming;
+        _utf8 = other._utf8;
+        _stats = other._stats;
+        other._streaming = false;
     }
-    return std::move(_global_value);
+    return *this;
 }
 
-void Parser::reset()
+Value Parser::parse(const std::string& string)
 {
-    _current_state = State::Initial;
-    _global_value = nullptr;
-    _depth_stack = {};
-    _key_stack = {};
+    return parse_tokens(string);
 }
 
-void Parser::consume(const Token& token)
+Value Parser::parse(std::string&& string)
+{
+    // The input outlives the call, so there is no need to take ownership of it.
+    return parse_tokens(string);
+}
+
+Value Parser::parse_file(const std::string& path)
+{
+    MappedFile file(path);
+    // the values copy what they keep, so the mapping can go once the tree is built
+    return parse_tokens(file.data(), std::pmr::get_default_resource(), FileIndexWindow);
+}
+
+Value Parser::parse_parallel(const std::string& string, std::size_t threads)
 {
-    State next_state = State::Error;
-    switch (_current_state)
+    Tokenizer tokenizer(string, _options.validate_utf8);
+    if (!tokenizer.valid_utf8())
+    {
+        throw ParserError("Invalid UTF-8");
+    }
+    const StructuralIndex& index = tokenizer.index();
+    if (index.size() == 0 || string[index[0]] != '[')
     {
-    case State::Initial: {
-        switch (token.type())
+        return parse_tokens(string);
+    }
+    // Byte offsets of the commas between top-level elements, and of the closing bracket.
+    std::vector<std::size_t> commas;
+    // The open containers, each as the character which closes it.
+    std::string closers;
+    std::size_t i = 0;
+    for (; i < index.size(); i++)
+    {
+        char c = string[index[i]];
+        if (c == '[' || c == '{')
         {
-        case Token::Type::String:
-            _global_value = std::move(strip_string_quotes(token.value()));
-            next_state = State::End;
-            break;
-        case Token::Type::Number:
-            _global_value = std::stod(token.value());
-            next_state = State::End;
-            break;
-        case Token::Type::KeywordTrue:
-            _global_value = true;
-            next_state = State::End;
-            break;
-        case Token::Type::KeywordFalse:
-            _global_value = false;
-            next_state = State::End;
-            break;
-        case Token::Type::KeywordNull:
-            _global_value = nullptr;
-            next_state = State::End;
-            break;
-        case Token::Type::LeftBrace:
-            _global_value = Value::Object();
-            _depth_stack.push(&_global_value);
-            next_state = State::Object;
-            break;
-        case Token::Type::LeftBracket:
-            _global_value = Value::Array();
-            _depth_stack.push(&_global_value);
-            next_state = State::Array;
-            break;
-        default:
-            break;
+            closers += c == '[' ? ']' : '}';
         }
-        break;
-    }
-    case State::Object: {
-        switch (token.type())
+        else if (c == ']' || c == '}')
         {
-        case Token::Type::RightBrace:
-            _depth_stack.pop();
-            if (_depth_stack.empty())
+            if (c != closers.back())
             {
-                next_state = State::End;
-            }
-            else if (_depth_stack.top()->type() == Value::Type::Array)
-            {
-                next_state = State::ArrayValue;
+                break;
             }
-            else  // _depth_stack.top()->type() == Value::Type::Object
+            closers.pop_back();
+            if (closers.empty())
             {
-                next_state = State::ObjectValue;
+                break;
             }
-            break;
-        case Token::Type::String:
-            _key_stack.push(strip_string_quotes(token.value()));
-            next_state = State::ObjectKey;
-            break;
-        default:
-            break;
         }
-        break;
-    }
-    case State::ObjectKey: {
-        switch (token.type())
+        else if (c == ',' && closers.size() == 1)
         {
-        case Token::Type::Colon:
-            next_state = State::ObjectColon;
-            break;
-        default:
-            break;
+            commas.push_back(index[i]);
         }
-        break;
     }
-    case State::ObjectColon: {
-        switch (token.type())
+    if (i + 1 != index.size() || !closers.empty())
+    {
+        // mismatched, unbalanced, or something after the root, let the sequential parser
+        // report it
+        return parse_tokens(string);
+    }
+    std::size_t first = index[0] + 1;
+    std::size_t last = index[i];
+
+    if (threads == 0)
+    {
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+        threads = std::min(threads, (last - first) / MinimumSliceSize);
+    }
+    threads = std::min(threads, commas.size() + 1);
+    if (threads < 2)
+    {
+        return parse_tokens(string);
+    }
+
+    // slices of roughly equal size, each ending at a top-level comma
+    std::vector<std::string_view> slices;
+    std::size_t start = first;
+    for (std::size_t k = 1; k < threads; k++)
+    {
+        std::size_t target = first + (last - first) * k / threads;
+        auto comma = std::lower_bound(commas.begin(), commas.end(), std::max(target, start));
+        if (comma == commas.end())
         {
-        case Token::Type::String:
-            _depth_stack.top()->get<Value::Object>().emplace(
-                _key_stack.top(), strip_string_quotes(token.value()));
-            _key_stack.pop();
-            next_state = State::ObjectValue;
-            break;
-        case Token::Type::Number:
-            _depth_stack.top()->get<Value::Object>().emplace(
-                _key_stack.top(), std::stod(token.value()));
-            _key_stack.pop();
-            next_state = State::ObjectValue;
-            break;
-        case Token::Type::KeywordTrue:
-            _depth_stack.top()->get<Value::Object>().emplace(_key_stack.top(), true);
-            _key_stack.pop();
-            next_state = State::ObjectValue;
-            break;
-        case Token::Type::KeywordFalse:
-            _depth_stack.top()->get<Value::Object>().emplace(_key_stack.top(), false);
-            _key_stack.pop();
-            next_state = State::ObjectValue;
-            break;
-        case Token::Type::KeywordNull:
-            _depth_stack.top()->get<Value::Object>().emplace(_key_stack.top(), nullptr);
-            _key_stack.pop();
-            next_state = State::ObjectValue;
-            break;
-        case Token::Type::LeftBrace:
-            _depth_stack.top()->get<Value::Object>().emplace(_key_stack.top(), Value::Object());
-            _depth_stack.push(&_depth_stack.top()->get<Value::Object>().at(_key_stack.top()));
-            _key_stack.pop();
-            next_state = State::Object;
-            break;
-        case Token::Type::LeftBracket:
-            _depth_stack.top()->get<Value::Object>().emplace(_key_stack.top(), Value::Array());
-            _depth_stack.push(&_depth_stack.top()->get<Value::Object>().at(_key_stack.top()));
-            _key_stack.pop();
-            next_state = State::Array;
-            break;
-        default:
             break;
         }
-        break;
+        slices.push_back(std::string_view(string).substr(start, *comma - start));
+        start = *comma + 1;
     }
-    case State::ObjectValue: {
-        switch (token.type())
+    slices.push_back(std::string_view(string).substr(start, last - start));
+
+    std::vector<Value::Array> results(slices.size());
+    std::vector<std::exception_ptr> errors(slices.size());
+    auto work = [&](std::size_t k)
+    {
+        try
         {
-        case Token::Type::Comma:
-            next_state = State::ObjectComma;
-            break;
-        case Token::Type::RightBrace:
-            _depth_stack.pop();
-            if (_depth_stack.empty())
-            {
-                next_state = State::End;
-            }
-            else if (_depth_stack.top()->type() == Value::Type::Array)
-            {
-                next_state = State::ArrayValue;
-            }
-            else  // _depth_stack.top()->type() == Value::Type::Object
-            {
-                next_state = State::ObjectValue;
-            }
-            break;
-        default:
-            break;
+            results[k] = parse_slice(slices[k], _options.integers);
         }
-        break;
-    }
-    case State::ObjectComma: {
-        switch (token.type())
+        catch (...)
         {
-        case Token::Type::String:
-            _key_stack.push(strip_string_quotes(token.value()));
-            next_state = State::ObjectKey;
-            break;
-        default:
-            break;
+            errors[k] = std::current_exception();
         }
-        break;
+    };
+    std::vector<std::thread> workers;
+    for (std::size_t k = 1; k < slices.size(); k++)
+    {
+        workers.emplace_back(work, k);
+    }
+    work(0);
+    for (std::thread& worker : workers)
+    {
+        worker.join();
     }
-    case State::Array: {
-        switch (token.type())
+    for (const std::exception_ptr& error : errors)
+    {
+        if (error)
         {
-        case Token::Type::RightBracket:
-            _depth_stack.pop();
-            if (_depth_stack.empty())
-            {
-                next_state = State::End;
-                break;
-            }
-            else if (_depth_stack.top()->type() == Value::Type::Array)
-            {
-                next_state = State::ArrayValue;
-            }
-            else  //_depth_stack.top()->type() == Value::Type::Object
-            {
-                next_state = State::ObjectValue;
-            }
-            break;
-        case Token::Type::String:
-            _depth_stack.top()->get<Value::Array>().emplace_back(
-                strip_string_quotes(token.value()));
-            next_state = State::ArrayValue;
-            break;
-        case Token::Type::Number:
-            _depth_stack.top()->get<Value::Array>().emplace_back(std::stod(token.value()));
-            next_state = State::ArrayValue;
-            break;
-        case Token::Type::KeywordTrue:
-            _depth_stack.top()->get<Value::Array>().emplace_back(true);
-            next_state = State::ArrayValue;
-            break;
-        case Token::Type::KeywordFalse:
-            _depth_stack.top()->get<Value::Array>().emplace_back(false);
-            next_state = State::ArrayValue;
-            break;
-        case Token::Type::KeywordNull:
-            _depth_stack.top()->get<Value::Array>().emplace_back(nullptr);
-            next_state = State::ArrayValue;
-            break;
-        case Token::Type::LeftBrace:
-            _depth_stack.top()->get<Value::Array>().emplace_back(Value::Object());
-            _depth_stack.push(&_depth_stack.top()->get<Value::Array>().back());
-            next_state = State::Object;
-            break;
-        case Token::Type::LeftBracket:
-            _depth_stack.top()->get<Value::Array>().emplace_back(Value::Array());
-            _depth_stack.push(&_depth_stack.top()->get<Value::Array>().back());
-            next_state = State::Array;
-            break;
-        default:
-            break;
+            std::rethrow_exception(error);
         }
-        break;
     }
-    case State::ArrayValue: {
-        switch (token.type())
+
+    // the elements are moved, not copied, into the first slice's array
+    Value::Array array = std::move(results[0]);
+    array.reserve(commas.size() + 1);
+    for (std::size_t k = 1; k < results.size(); k++)
+    {
+        array.insert(
+            array.end(),
+            std::make_move_iterator(results[k].begin()),
+            std::make_move_iterator(results[k].end()));
+    }
+    return Value(std::move(array));
+}
+
+const char* ValidationResult::message() const
+{
+    switch (error)
+    {
+    case Error::None:
+        return "Valid JSON";
+    case Error::InvalidUtf8:
+        return "Invalid UTF-8";
+    case Error::InvalidToken:
+        return "Invalid token";
+    case Error::UnexpectedToken:
+        return "Unexpected token";
+    case Error::UnexpectedEnd:
+        return "Unexpected end of input";
+    case Error::TrailingContent:
+        return "Unexpected content after the document";
+    }
+    return "";
+}
+
+ValidationResult Parser::validate(const std::string& string)
+{
+    stats::Scope scope(_stats, string.size());
+    _reader.reset();
+    _tokenizer.reset(string, _options.validate_utf8);
+    scope.indexed();
+    if (!_tokenizer.valid_utf8())
+    {
+        return {ValidationResult::Error::InvalidUtf8, invalid_utf8_offset(string)};
+    }
+    if (_validator.check(string, _tokenizer.index()))
+    {
+        return {};
+    }
+    // the same grammar as parse(), with a handler which accepts everything
+    NullHandler handler;
+    Token token;
+    do
+    {
+        token = _tokenizer.next();
+        bool complete = _reader.done();
+        if (_reader.consume(token, handler) == Reader::State::Error)
         {
-        case Token::Type::Comma:
-            next_state = State::ArrayComma;
-            break;
-        case Token::Type::RightBracket:
-            _depth_stack.pop();
-            if (_depth_stack.empty())
+            ValidationResult::Error error = ValidationResult::Error::UnexpectedToken;
+            if (token.type() == Token::Type::Invalid)
             {
-                next_state = State::End;
-                break;
+                error = ValidationResult::Error::InvalidToken;
             }
-            else if (_depth_stack.top()->type() == Value::Type::Array)
+            else if (token.type() == Token::Type::End)
             {
-                next_state = State::ArrayValue;
+                error = ValidationResult::Error::UnexpectedEnd;
             }
-            else  //_depth_stack.top()->type() == Value::Type::Object
+            else if (complete)
             {
-                next_state = State::ObjectValue;
+                error = ValidationResult::Error::TrailingContent;
             }
-            break;
-        default:
-            break;
+            std::size_t offset = token.type() == Token::Type::End
+                ? string.size()
+                : static_cast<std::size_t>(token.value().data() - string.data());
+            return {error, offset};
         }
-        break;
     }
-    case State::ArrayComma: {
-        switch (token.type())
+    while (token.type() != Token::Type::End);
+    return {};
+}
+
+void Parser::parse(const std::string& string, Document& document)
+{
+    document.clear();
+    try
+    {
+        document.root() = parse_tokens(string, document.resource());
+    }
+    catch (...)
+    {
+        // a partial tree must not outlive the arena it was allocated from
+        _builder.clear();
+        throw;
+    }
+}
+
+void Parser::parse(const std::string& string, TapeDocument& document)
+{
+    document.clear();
+    _tape_builder.reset(document, _options.keys);
+    if (!parse(string, _tape_builder))
+    {
+        throw ParserError("Invalid JSON");
+    }
+}
+
+LazyDocument Parser::parse_lazy(const std::string& string)
+{
+    return LazyDocument(string, _options.integers, _options.validate_utf8);
+}
+
+LazyDocument Parser::parse_lazy(std::string&& string)
+{
+    return LazyDocument(std::move(string), _options.integers, _options.validate_utf8);
+}
+
+std::vector<std::optional<Value>> Parser::extract(const std::string& string, const Query& query)
+{
+    return query.extract(LazyDocument(string, _options.integers, _options.validate_utf8));
+}
+
+Value Parser::parse_tokens(
+    std::string_view string, std::pmr::memory_resource* resource, std::size_t window)
+{
+    stats::Scope scope(_stats, string.size());
+    resource = stats::counted(resource);
+    reset(resource);
+    _tokenizer.reset(string, _options.validate_utf8, window);
+    scope.indexed();
+    if (!_tokenizer.valid_utf8())
+    {
+        throw ParserError("Invalid UTF-8");
+    }
+    if (_options.engine == Engine::Descent)
+    {
+        _descent.reset(_options.integers, resource);
+        return _descent.parse(_tokenizer);
+    }
+    // tokens are consumed as they are produced, the reader reports invalid ones
+    Token token;
+    do
+    {
+        token = _tokenizer.next();
+        consume(token);
+    }
+    while (token.type() != Token::Type::End && !_reader.failed());
+    return result();
+}
+
+void Parser::feed(const char* data, std::size_t size)
+{
+    stats::Scope scope(_stats, size, _streaming);
+    if (!_streaming)
+    {
+        start_stream();
+    }
+    if (_options.validate_utf8)
+    {
+        _utf8.check(data, size);
+        if (_utf8.failed())
         {
-        case Token::Type::String:
-            _depth_stack.top()->get<Value::Array>().emplace_back(
-                strip_string_quotes(token.value()));
-            next_state = State::ArrayValue;
-            break;
-        case Token::Type::Number:
-            _depth_stack.top()->get<Value::Array>().emplace_back(std::stod(token.value()));
-            next_state = State::ArrayValue;
-            break;
-        case Token::Type::KeywordTrue:
-            _depth_stack.top()->get<Value::Array>().emplace_back(true);
-            next_state = State::ArrayValue;
-            break;
-        case Token::Type::KeywordFalse:
-            _depth_stack.top()->get<Value::Array>().emplace_back(false);
-            next_state = State::ArrayValue;
-            break;
-        case Token::Type::KeywordNull:
-            _depth_stack.top()->get<Value::Array>().emplace_back(nullptr);
-            next_state = State::ArrayValue;
-            break;
-        case Token::Type::LeftBrace:
-            _depth_stack.top()->get<Value::Array>().emplace_back(Value::Object());
-            _depth_stack.push(&_depth_stack.top()->get<Value::Array>().back());
-            next_state = State::Object;
-            break;
-        case Token::Type::LeftBracket:
-            _depth_stack.top()->get<Value::Array>().emplace_back(Value::Array());
-            _depth_stack.push(&_depth_stack.top()->get<Value::Array>().back());
-            next_state = State::Array;
-            break;
-        default:
-            break;
+            _streaming = false;
+            throw ParserError("Invalid UTF-8");
         }
-        break;
     }
-    case State::End: {
-        switch (token.type())
+    _stream.feed(data, size);
+    consume_stream();
+}
+
+void Parser::feed(std::string_view chunk)
+{
+    feed(chunk.data(), chunk.size());
+}
+
+Value Parser::finish()
+{
+    stats::Scope scope(_stats, 0, _streaming);
+    if (!_streaming)
+    {
+        start_stream();
+    }
+    if (_options.validate_utf8 && !_utf8.finish())
+    {
+        // the input ends inside a sequence
+        _streaming = false;
+        throw ParserError("Invalid UTF-8");
+    }
+    _stream.finish();
+    consume_stream();
+    _streaming = false;
+    return result();
+}
+
+void Parser::consume_stream()
+{
+    Token token;
+    while (_stream.next(token))
+    {
+#if defined(YAJP_STATS)
+        _stats.count(token);
+#endif
+        // invalid tokens put the reader into its error state
+        consume(token);
+        if (_reader.failed())
         {
-        case Token::Type::End: {
-            next_state = State::End;
-            break;
-        }
-        default:
-            break;
+            // the next feed() starts a new document
+            _streaming = false;
+            throw ParserError("Invalid JSON");
         }
-        break;
     }
-    case State::Error:
-    default:
-        break;
-    }
-    _current_state = next_state;
 }
 
-std::string Parser::strip_string_quotes(const std::string& string) const
+void Parser::start_stream()
+{
+    _streaming = true;
+    _stream.reset();
+    _utf8.reset();
+    reset(stats::counted(std::pmr::get_default_resource()));
+}
+
+void Parser::reset(std::pmr::memory_resource* resource)
+{
+    _reader.reset();
+    _builder.reset(_options.integers, _streaming, resource);
+}
+
+void Parser::consume(const Token& token)
+{
+    _reader.consume(token, _builder);
+}
+
+Value Parser::result()
 {
-    return string.substr(1, string.size() - 2);
+    if (!_reader.done())
+    {
+        throw ParserError("Invalid JSON");
+    }
+    return _builder.take();
 }
 
 }
@@ -1,60 +1,236 @@
 #pragma once
 #include "value.h"
+#include "parser_error.h"
 #include "token.h"
+#include "tokenizer.h"
+#include "stream_tokenizer.h"
+#include "reader.h"
+#include "value_builder.h"
+#include "descent_parser.h"
+#include "validator.h"
+#include "typed_reader.h"
+#include "tape_builder.h"
+#include "document.h"
+#include "tape.h"
+#include "key_table.h"
+#include "lazy.h"
+#include "query.h"
+#include "mapped_file.h"
+#include "utf8.h"
+#include "stats.h"
 #include <string>
-#include <stack>
+#include <string_view>
 #include <vector>
+#include <optional>
+#include <memory>
 #include <stdexcept>
 #include <cstddef>
 
 namespace yajp
 {
 
+// Outcome of Parser::validate().
+struct ValidationResult
+{
+    enum class Error
+    {
+        None,
+        // The input is not well-formed UTF-8, only checked if Parser::Options::validate_utf8.
+        InvalidUtf8,
+        // Bytes which do not form a token, such as a malformed number or string.
+        InvalidToken,
+        // A token the grammar does not allow at that point.
+        UnexpectedToken,
+        // The input ends inside the document, or is empty.
+        UnexpectedEnd,
+        // Something follows the document.
+        TrailingContent,
+    };
+
+    Error error = Error::None;
+    // Byte offset at which the input stopped being valid: the start of the offending token, the
+    // input size for UnexpectedEnd, or the offending byte for InvalidUtf8.
+    std::size_t offset = 0;
+
+    bool valid() const { return error == Error::None; }
+    explicit operator bool() const { return valid(); }
+    const char* message() const;
+};
+
+// A parser keeps its tokenizer index, reader stack and builder buffers between documents, so
+// reusing one instance for many documents of similar shape avoids allocating them again. Paired
+// with a recycled Document or TapeDocument, parsing reaches a steady state without allocations.
 class Parser
 {
   public:
-    Parser() = default;
+    enum class Engine
+    {
+        // Tokens drive the Reader's state machine, which reports them to a ValueBuilder.
+        Reader,
+        // Values are constructed in place by a DescentParser.
+        Descent,
+    };
+
+    struct Options
+    {
+        // Store integers which fit into 64 bits as Value::Integer instead of Value::Number.
+        bool integers = false;
+        // Reject input which is not well-formed UTF-8. The check runs in the tokenizer's
+        // indexing pass, trusted input can skip it.
+        bool validate_utf8 = false;
+        // Builds the trees returned by parse() and parse_file() and those parsed into a
+        // Document. Push parsing, handlers and the other document types always use the Reader.
+        Engine engine = Engine::Reader;
+        // Interns the keys of TapeDocuments parsed by this parser in this table, see KeyTable.
+        // Each key is then stored once for all documents instead of in every document's string
+        // buffer, and ObjectView lookups compare key numbers. The table keeps every distinct
+        // key it is given until it reaches its limits, after which new keys are stored in the
+        // documents again, so for untrusted input keep the limits small or clear it.
+        std::shared_ptr<KeyTable> keys;
+    };
+
+    Parser();
+    explicit Parser(const Options& options);
+
+    // Index window for parse_file(), the index buffer takes four bytes per input byte.
+    static constexpr std::size_t FileIndexWindow = 4 * 1024 * 1024;
+
+    // Parts of a parser refer to each other, so it cannot be copied. Moving keeps the options,
+    // the statistics and a document being pushed through feed(), the buffers which are only
+    // reused between documents start out empty again.
+    Parser(const Parser&) = delete;
+    Parser& operator=(const Parser&) = delete;
+    Parser(Parser&& other);
+    Parser& operator=(Parser&& other);
 
     Value parse(const std::string& string);
     Value parse(std::string&& string);
+    // Maps the file and tokenizes it in place, see MappedFile. The structural index is built
+    // in windows of FileIndexWindow bytes as parsing proceeds, so besides the tree only a
+    // bounded index buffer is allocated, whatever the file size. Throws std::system_error if
+    // the file cannot be read.
+    Value parse_file(const std::string& path);
 
-    Value parse_lazy(const std::string& string);
-    Value parse_lazy(std::string&& string);
+    // For documents whose root is an array: the elements are split into slices at top-level
+    // commas found through the structural index, the slices are parsed on `threads` threads
+    // and their elements are moved into one array. 0 uses one thread per hardware thread, but
+    // not more than input size allows for reasonably large slices. Any other document is
+    // parsed as by parse().
+    Value parse_parallel(const std::string& string, std::size_t threads = 0);
 
-  private:
-    enum class State
-    {
-        Initial,
-        End,
-        Object,
-        ObjectKey,
-        ObjectColon,
-        ObjectValue,
-        ObjectComma,
-        Array,
-        ArrayValue,
-        ArrayComma,
-        Error,
-    };
+    // Only checks that the input is a single JSON document, nothing is built: strings are not
+    // decoded and numbers are not converted. Reports the first error instead of throwing.
+    // Valid input is checked on the structural index alone (see Validator), invalid input is
+    // tokenized again to locate the error.
+    ValidationResult validate(const std::string& string);
 
-    // This stack is used to reference nested structures.
-    std::stack<Value*, std::vector<Value*>> _depth_stack;
-    // This stack is used to parse key value pairs for objects.
-    std::stack<Value::String, std::vector<Value::String>> _key_stack;
-    Value _global_value;
-    State _current_state;
+    // Builds the tree in the document's arena, replacing its previous contents.
+    void parse(const std::string& string, Document& document);
+    // Writes the document onto a tape, replacing its previous contents.
+    void parse(const std::string& string, TapeDocument& document);
 
-    void reset();
+    // Only builds the structural index, values are located and parsed when they are accessed,
+    // see LazyDocument.
+    LazyDocument parse_lazy(const std::string& string);
+    LazyDocument parse_lazy(std::string&& string);
+
+    // Extracts only the values the query's pointers refer to, see Query.
+    std::vector<std::optional<Value>> extract(const std::string& string, const Query& query);
+
+    // Reads the document straight into `target`, which may be a struct described by a Binding
+    // (see YAJP_BIND), without building a Value. See TypedReader for the supported types.
+    template <typename T>
+    void parse_into(const std::string& string, T& target);
+
+    // Reports the document to a handler instead of building a Value, see Reader for the
+    // handler interface. Returns false if the handler stopped the parser.
+    template <typename Handler>
+    bool parse(const std::string& string, Handler& handler);
+
+    // Push parsing, the document can be split into chunks at any byte. Tokens are parsed as
+    // soon as they are complete, so errors are reported by the feed() which completes them.
+    void feed(const char* data, std::size_t size);
+    void feed(std::string_view chunk);
+    Value finish();
+
+    // Totals over the documents parsed since construction or reset_stats(), only collected if
+    // the library is built with YAJP_STATS, see ParseStats. The lazy and parallel entry points
+    // are not counted.
+    const ParseStats& stats() const { return _stats; }
+    void reset_stats() { _stats = ParseStats(); }
+
+  private:
+    Tokenizer _tokenizer;
+    Reader _reader;
+    ValueBuilder _builder;
+    DescentParser _descent;
+    Validator _validator;
+    TypedReader _typed;
+    TapeBuilder _tape_builder;
+    Options _options;
+    StreamTokenizer _stream;
+    bool _streaming = false;
+    // Chunks are validated as they are fed, sequences may be split between them.
+    utf8::ScalarValidator _utf8;
+    ParseStats _stats;
+
+    // `window` is passed on to Tokenizer::reset.
+    Value parse_tokens(
+        std::string_view string,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource(),
+        std::size_t window = 0);
+    void reset(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
     void consume(const Token& token);
-    Value::String strip_string_quotes(const Value::String& string) const;
+    void consume_stream();
+    void start_stream();
+    Value result();
 };
 
-class ParserError : std::runtime_error
+template <typename T>
+void Parser::parse_into(const std::string& string, T& target)
 {
-  public:
-    ParserError(const std::string& message) : std::runtime_error(message) {}
+    stats::Scope scope(_stats, string.size());
+    _tokenizer.reset(string, _options.validate_utf8);
+    scope.indexed();
+    if (!_tokenizer.valid_utf8())
+    {
+        throw ParserError("Invalid UTF-8");
+    }
+    _typed.set_integers(_options.integers);
+    _typed.read(target);
+    if (_tokenizer.next().type() != Token::Type::End)
+    {
+        throw ParserError("Invalid JSON");
+    }
+}
 
-    ParserError(const char* message) : std::runtime_error(message) {}
-};
+template <typename Handler>
+bool Parser::parse(const std::string& string, Handler& handler)
+{
+    stats::Scope scope(_stats, string.size());
+    _reader.reset();
+    _tokenizer.reset(string, _options.validate_utf8);
+    scope.indexed();
+    if (!_tokenizer.valid_utf8())
+    {
+        throw ParserError("Invalid UTF-8");
+    }
+    Token token;
+    do
+    {
+        token = _tokenizer.next();
+        switch (_reader.consume(token, handler))
+        {
+        case Reader::State::Stopped:
+            return false;
+        case Reader::State::Error:
+            throw ParserError("Invalid JSON");
+        default:
+            break;
+        }
+    }
+    while (token.type() != Token::Type::End);
+    return true;
+}
 
 }
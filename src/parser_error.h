@@ -0,0 +1,16 @@
+#pragma once
+#include <string>
+#include <stdexcept>
+
+namespace yajp
+{
+
+class ParserError : public std::runtime_error
+{
+  public:
+    ParserError(const std::string& message) : std::runtime_error(message) {}
+
+    ParserError(const char* message) : std::runtime_error(message) {}
+};
+
+}
@@ -0,0 +1,218 @@
+#include "query.h"
+#include <stdexcept>
+#include <utility>
+
+namespace yajp
+{
+
+namespace
+{
+
+std::size_t array_index(std::string_view token)
+{
+    // RFC 6901: "0" or a number without leading zeros, "-" never refers to an existing element
+    if (token.empty() || (token.size() > 1 && token[0] == '0'))
+    {
+        return std::string::npos;
+    }
+    std::size_t index = 0;
+    for (char c : token)
+    {
+        if (c < '0' || c > '9' || index > (std::string::npos - 10) / 10)
+        {
+            return std::string::npos;
+        }
+        index = index * 10 + (c - '0');
+    }
+    return index;
+}
+
+std::string decode_token(std::string_view token)
+{
+    std::string decoded;
+    decoded.reserve(token.size());
+    for (std::size_t i = 0; i < token.size(); i++)
+    {
+        if (token[i] != '~')
+        {
+            decoded += token[i];
+        }
+        else if (i + 1 < token.size() && (token[i + 1] == '0' || token[i + 1] == '1'))
+        {
+            decoded += token[++i] == '0' ? '~' : '/';
+        }
+        else
+        {
+            throw std::invalid_argument("Invalid escape sequence in JSON Pointer");
+        }
+    }
+    return decoded;
+}
+
+}
+
+Query::Query(const std::vector<std::string>& pointers) : _nodes(1), _size(pointers.size())
+{
+    _nodes[0].index = std::string::npos;
+    for (std::size_t target = 0; target < pointers.size(); target++)
+    {
+        std::string_view pointer = pointers[target];
+        if (!pointer.empty() && pointer[0] != '/')
+        {
+            throw std::invalid_argument("JSON Pointer has to start with '/'");
+        }
+        std::size_t node = 0;
+        while (!pointer.empty())
+        {
+            pointer.remove_prefix(1);
+            std::size_t end = pointer.find('/');
+            node = child(node, decode_token(pointer.substr(0, end)));
+            pointer.remove_prefix(end == std::string_view::npos ? pointer.size() : end);
+        }
+        if (_nodes[node].targets.empty())
+        {
+            _terminals++;
+        }
+        _nodes[node].targets.push_back(target);
+    }
+}
+
+std::vector<std::optional<Value>> Query::extract(const LazyDocument& document) const
+{
+    std::vector<std::optional<Value>> results(_size);
+    if (_size != 0)
+    {
+        Walk state{document, results, std::vector<bool>(_nodes.size()), _terminals};
+        walk(state, 0, 0);
+    }
+    return results;
+}
+
+std::size_t Query::child(std::size_t node, std::string_view token)
+{
+    for (std::size_t child : _nodes[node].children)
+    {
+        if (_nodes[child].token == token)
+        {
+            return child;
+        }
+    }
+    _nodes.push_back(Node{std::string(token), array_index(token), {}, {}});
+    _nodes[node].children.push_back(_nodes.size() - 1);
+    return _nodes.size() - 1;
+}
+
+std::size_t Query::walk(Walk& state, std::size_t node, std::size_t i) const
+{
+    state.visited[node] = true;
+    const Node& current = _nodes[node];
+    if (!current.targets.empty())
+    {
+        Value value = LazyValue(&state.document, i).materialize();
+        for (std::size_t k = 1; k < current.targets.size(); k++)
+        {
+            state.results[current.targets[k]] = value;
+        }
+        state.results[current.targets[0]] = std::move(value);
+        if (--state.remaining == 0)
+        {
+            return i;
+        }
+    }
+    if (current.children.empty())
+    {
+        return state.document.skip(i);
+    }
+    switch (state.document.at(i))
+    {
+    case '{':
+        return walk_object(state, node, i);
+    case '[':
+        return walk_array(state, node, i);
+    default:
+        // nothing below a scalar
+        return state.document.skip(i);
+    }
+}
+
+std::size_t Query::walk_object(Walk& state, std::size_t node, std::size_t i) const
+{
+    const Node& current = _nodes[node];
+    std::size_t pending = current.children.size();
+    LazyValue object(&state.document, i);
+    std::string buffer;
+    for (i = object.first('{'); state.document.at(i) != '}'; i = object.separator(i, '}'))
+    {
+        std::string_view key = object.key(i, buffer);
+        std::size_t match = 0;
+        for (std::size_t child : current.children)
+        {
+            // with duplicate keys the first member wins
+            if (!state.visited[child] && _nodes[child].token == key)
+            {
+                match = child;
+                break;
+            }
+        }
+        if (match == 0)
+        {
+            i = state.document.skip(i + 2);
+            continue;
+        }
+        i = walk(state, match, i + 2);
+        if (state.remaining == 0)
+        {
+            return i;
+        }
+        if (--pending == 0)
+        {
+            return state.document.close(i);
+        }
+    }
+    return i + 1;
+}
+
+std::size_t Query::walk_array(Walk& state, std::size_t node, std::size_t i) const
+{
+    const Node& current = _nodes[node];
+    std::size_t pending = 0;
+    for (std::size_t child : current.children)
+    {
+        pending += _nodes[child].index != std::string::npos;
+    }
+    if (pending == 0)
+    {
+        return state.document.skip(i);
+    }
+    LazyValue array(&state.document, i);
+    std::size_t index = 0;
+    for (i = array.first('['); state.document.at(i) != ']'; i = array.separator(i, ']'), index++)
+    {
+        std::size_t match = 0;
+        for (std::size_t child : current.children)
+        {
+            if (_nodes[child].index == index)
+            {
+                match = child;
+                break;
+            }
+        }
+        if (match == 0)
+        {
+            i = state.document.skip(i);
+            continue;
+        }
+        i = walk(state, match, i);
+        if (state.remaining == 0)
+        {
+            return i;
+        }
+        if (--pending == 0)
+        {
+            return state.document.close(i);
+        }
+    }
+    return i + 1;
+}
+
+}
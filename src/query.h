@@ -0,0 +1,65 @@
+#pragma once
+#include "value.h"
+#include "lazy.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <cstddef>
+
+namespace yajp
+{
+
+// A set of JSON Pointers (RFC 6901) compiled into a trie, so a document is walked once for all
+// of them. The walk runs over the structural index like LazyDocument does: members and elements
+// which no pointer goes through are skipped by bracket matching without being parsed, and the
+// walk stops as soon as every pointer has been resolved. As with LazyDocument, the parts of the
+// document which are skipped are not validated.
+//
+// A query is immutable once compiled and can be shared between threads.
+class Query
+{
+  public:
+    // Throws std::invalid_argument for a malformed pointer.
+    explicit Query(const std::vector<std::string>& pointers);
+
+    std::size_t size() const { return _size; }
+
+    // One result per pointer, in the order they were given, empty if the pointer does not
+    // resolve. Throws ParserError if the walk reaches malformed JSON.
+    std::vector<std::optional<Value>> extract(const LazyDocument& document) const;
+
+  private:
+    struct Node
+    {
+        // Reference token, with ~0 and ~1 decoded.
+        std::string token;
+        // The token as an array index, npos if it is not one.
+        std::size_t index;
+        // Pointers which end at this node.
+        std::vector<std::size_t> targets;
+        std::vector<std::size_t> children;
+    };
+
+    struct Walk
+    {
+        const LazyDocument& document;
+        std::vector<std::optional<Value>>& results;
+        std::vector<bool> visited;
+        std::size_t remaining;
+    };
+
+    // _nodes[0] is the document root.
+    std::vector<Node> _nodes;
+    std::size_t _size = 0;
+    // Number of nodes with targets.
+    std::size_t _terminals = 0;
+
+    std::size_t child(std::size_t node, std::string_view token);
+    // Index position after the value at `i`, or anything once state.remaining drops to zero.
+    std::size_t walk(Walk& state, std::size_t node, std::size_t i) const;
+    std::size_t walk_object(Walk& state, std::size_t node, std::size_t i) const;
+    std::size_t walk_array(Walk& state, std::size_t node, std::size_t i) const;
+};
+
+}
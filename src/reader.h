@@ -0,0 +1,222 @@
+#pragma once
+#include "token.h"
+#include <vector>
+#include <string_view>
+#include <cstddef>
+
+namespace yajp
+{
+
+// The JSON grammar as a state machine driven one token at a time. Every value is reported to a
+// handler, which has to provide the member functions below. Returning false from any of them
+// stops the reader.
+//
+//     bool null();
+//     bool boolean(bool value);
+//     bool number(std::string_view literal);
+//     bool string(std::string_view contents);  // without quotes, see unescape() for decoding
+//     bool key(std::string_view contents);     // same as string
+//     bool start_object();
+//     bool end_object();
+//     bool start_array();
+//     bool end_array();
+//
+// consume() is a template on the handler, so that the calls can be inlined.
+class Reader
+{
+  public:
+    enum class State
+    {
+        Initial,
+        End,
+        Object,
+        ObjectKey,
+        ObjectColon,
+        ObjectValue,
+        ObjectComma,
+        Array,
+        ArrayValue,
+        ArrayComma,
+        Error,
+        // The handler asked to stop.
+        Stopped,
+    };
+
+    Reader() = default;
+
+    void reset();
+
+    State state() const { return _state; }
+    // The document is complete once the reader reaches State::End.
+    bool done() const { return _state == State::End; }
+    bool failed() const { return _state == State::Error || _state == State::Stopped; }
+    std::size_t depth() const { return _containers.size(); }
+
+    template <typename Handler>
+    State consume(const Token& token, Handler& handler);
+
+  private:
+    State _state = State::Initial;
+    // One bit per open container, set for objects and cleared for arrays.
+    std::vector<bool> _containers;
+
+    template <typename Handler>
+    State value(const Token& token, Handler& handler);
+    template <typename Handler>
+    State close(bool object, Handler& handler);
+    State after_value() const;
+
+    static std::string_view contents(const Token& token)
+    {
+        return token.value().substr(1, token.value().size() - 2);
+    }
+};
+
+// Handler which accepts everything the grammar allows, for checking input without using it.
+struct NullHandler
+{
+    bool null() { return true; }
+    bool boolean(bool) { return true; }
+    bool string(std::string_view) { return true; }
+    bool number(std::string_view) { return true; }
+    bool key(std::string_view) { return true; }
+    bool start_object() { return true; }
+    bool end_object() { return true; }
+    bool start_array() { return true; }
+    bool end_array() { return true; }
+};
+
+inline void Reader::reset()
+{
+    _state = State::Initial;
+    _containers.clear();
+}
+
+template <typename Handler>
+Reader::State Reader::consume(const Token& token, Handler& handler)
+{
+    State next_state = State::Error;
+    switch (_state)
+    {
+    case State::Initial:
+    case State::ObjectColon:
+    case State::ArrayComma:
+        next_state = value(token, handler);
+        break;
+    case State::Object:
+    case State::ObjectComma:
+        if (token.type() == Token::Type::String)
+        {
+            next_state = handler.key(contents(token)) ? State::ObjectKey : State::Stopped;
+        }
+        else if (token.type() == Token::Type::RightBrace && _state == State::Object)
+        {
+            next_state = close(true, handler);
+        }
+        break;
+    case State::ObjectKey:
+        if (token.type() == Token::Type::Colon)
+        {
+            next_state = State::ObjectColon;
+        }
+        break;
+    case State::ObjectValue:
+        if (token.type() == Token::Type::Comma)
+        {
+            next_state = State::ObjectComma;
+        }
+        else if (token.type() == Token::Type::RightBrace)
+        {
+            next_state = close(true, handler);
+        }
+        break;
+    case State::Array:
+        if (token.type() == Token::Type::RightBracket)
+        {
+            next_state = close(false, handler);
+        }
+        else
+        {
+            next_state = value(token, handler);
+        }
+        break;
+    case State::ArrayValue:
+        if (token.type() == Token::Type::Comma)
+        {
+            next_state = State::ArrayComma;
+        }
+        else if (token.type() == Token::Type::RightBracket)
+        {
+            next_state = close(false, handler);
+        }
+        break;
+    case State::End:
+        if (token.type() == Token::Type::End)
+        {
+            next_state = State::End;
+        }
+        break;
+    case State::Error:
+    case State::Stopped:
+    default:
+        next_state = _state;
+        break;
+    }
+    _state = next_state;
+    return _state;
+}
+
+template <typename Handler>
+Reader::State Reader::value(const Token& token, Handler& handler)
+{
+    bool proceed = true;
+    switch (token.type())
+    {
+    case Token::Type::String:
+        proceed = handler.string(contents(token));
+        break;
+    case Token::Type::Number:
+        proceed = handler.number(token.value());
+        break;
+    case Token::Type::KeywordTrue:
+        proceed = handler.boolean(true);
+        break;
+    case Token::Type::KeywordFalse:
+        proceed = handler.boolean(false);
+        break;
+    case Token::Type::KeywordNull:
+        proceed = handler.null();
+        break;
+    case Token::Type::LeftBrace:
+        _containers.push_back(true);
+        return handler.start_object() ? State::Object : State::Stopped;
+    case Token::Type::LeftBracket:
+        _containers.push_back(false);
+        return handler.start_array() ? State::Array : State::Stopped;
+    default:
+        return State::Error;
+    }
+    return proceed ? after_value() : State::Stopped;
+}
+
+template <typename Handler>
+Reader::State Reader::close(bool object, Handler& handler)
+{
+    _containers.pop_back();
+    if (!(object ? handler.end_object() : handler.end_array()))
+    {
+        return State::Stopped;
+    }
+    return after_value();
+}
+
+inline Reader::State Reader::after_value() const
+{
+    if (_containers.empty())
+    {
+        return State::End;
+    }
+    return _containers.back() ? State::ObjectValue : State::ArrayValue;
+}
+
+}
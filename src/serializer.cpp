@@ -0,0 +1,245 @@
+#include "serializer.h"
+#include "string_scan.h"
+#include <charconv>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <cmath>
+#include <cerrno>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace yajp
+{
+
+Serializer::Serializer(const Options& options) : _options(options)
+{}
+
+std::string_view Serializer::serialize(const Value& value)
+{
+    _buffer.clear();
+    write(value, 0);
+    return _buffer;
+}
+
+void Serializer::serialize(const Value& value, std::string& output)
+{
+    // write straight into the caller's string
+    std::swap(_buffer, output);
+    try
+    {
+        write(value, 0);
+    }
+    catch (...)
+    {
+        std::swap(_buffer, output);
+        throw;
+    }
+    std::swap(_buffer, output);
+}
+
+void Serializer::serialize(const Value& value, const std::function<void(std::string_view)>& sink)
+{
+    _buffer.clear();
+    _sink = &sink;
+    try
+    {
+        write(value, 0);
+        flush();
+    }
+    catch (...)
+    {
+        _sink = nullptr;
+        throw;
+    }
+    _sink = nullptr;
+}
+
+void Serializer::serialize(const Value& value, int fd)
+{
+    serialize(
+        value,
+        [fd](std::string_view chunk)
+        {
+            while (!chunk.empty())
+            {
+#ifdef _WIN32
+                int written = _write(fd, chunk.data(), static_cast<unsigned>(chunk.size()));
+#else
+                ssize_t written = ::write(fd, chunk.data(), chunk.size());
+#endif
+                if (written < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    throw std::system_error(errno, std::generic_category(), "write");
+                }
+                chunk.remove_prefix(static_cast<std::size_t>(written));
+            }
+        });
+}
+
+void Serializer::write(const Value& value, std::size_t depth)
+{
+    if (_sink != nullptr && _buffer.size() >= FlushSize)
+    {
+        flush();
+    }
+    switch (value.type())
+    {
+    case Value::Type::Null:
+        _buffer += "null";
+        break;
+    case Value::Type::Bool:
+        _buffer += value.get<Value::Type::Bool>() ? "true" : "false";
+        break;
+    case Value::Type::Number:
+        append_json_number(_buffer, value.get<Value::Type::Number>());
+        break;
+    case Value::Type::Integer:
+        append_json_integer(_buffer, value.get<Value::Type::Integer>());
+        break;
+    case Value::Type::String:
+        append_json_string(_buffer, value.get<Value::Type::String>());
+        break;
+    case Value::Type::Array: {
+        const Value::Array& array = value.get<Value::Type::Array>();
+        _buffer += '[';
+        for (std::size_t i = 0; i < array.size(); i++)
+        {
+            if (i != 0)
+            {
+                _buffer += ',';
+            }
+            newline(depth + 1);
+            write(array[i], depth + 1);
+        }
+        if (!array.empty())
+        {
+            newline(depth);
+        }
+        _buffer += ']';
+        break;
+    }
+    case Value::Type::Object: {
+        const Value::Object& object = value.get<Value::Type::Object>();
+        _buffer += '{';
+        bool first = true;
+        for (const auto& [key, member] : object)
+        {
+            if (!first)
+            {
+                _buffer += ',';
+            }
+            first = false;
+            newline(depth + 1);
+            append_json_string(_buffer, key);
+            _buffer += _options.pretty ? ": " : ":";
+            write(member, depth + 1);
+        }
+        if (!first)
+        {
+            newline(depth);
+        }
+        _buffer += '}';
+        break;
+    }
+    }
+}
+
+void append_json_string(std::string& output, std::string_view string)
+{
+    static constexpr char hex[] = "0123456789abcdef";
+    const char* c = string.data();
+    const char* last = c + string.size();
+    output += '"';
+    while (true)
+    {
+        // runs without anything to escape are copied in one go
+        const char* special = find_string_special(c, last);
+        output.append(c, special);
+        if (special == last)
+        {
+            break;
+        }
+        c = special + 1;
+        switch (*special)
+        {
+        case '"':
+            output += "\\\"";
+            break;
+        case '\\':
+            output += "\\\\";
+            break;
+        case '\b':
+            output += "\\b";
+            break;
+        case '\f':
+            output += "\\f";
+            break;
+        case '\n':
+            output += "\\n";
+            break;
+        case '\r':
+            output += "\\r";
+            break;
+        case '\t':
+            output += "\\t";
+            break;
+        default: {
+            // other control characters, and DEL, which JSON allows unescaped but the tokenizer
+            // rejects
+            unsigned char byte = static_cast<unsigned char>(*special);
+            char escape[] = {'\\', 'u', '0', '0', hex[byte >> 4], hex[byte & 0xF]};
+            output.append(escape, sizeof(escape));
+            break;
+        }
+        }
+    }
+    output += '"';
+}
+
+void append_json_number(std::string& output, double number)
+{
+    if (!std::isfinite(number))
+    {
+        throw std::invalid_argument("JSON cannot represent infinite or NaN numbers");
+    }
+    char digits[32];
+    // without a format or precision to_chars gives the shortest round-trip representation
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), number);
+    output.append(digits, result.ptr);
+}
+
+void append_json_integer(std::string& output, Value::Integer integer)
+{
+    char digits[24];
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), integer);
+    output.append(digits, result.ptr);
+}
+
+void Serializer::newline(std::size_t depth)
+{
+    if (_options.pretty)
+    {
+        _buffer += '\n';
+        _buffer.append(depth * _options.indent, ' ');
+    }
+}
+
+void Serializer::flush()
+{
+    if (!_buffer.empty())
+    {
+        (*_sink)(_buffer);
+        _buffer.clear();
+    }
+}
+
+}
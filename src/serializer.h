@@ -0,0 +1,59 @@
+#pragma once
+#include "value.h"
+#include <string>
+#include <string_view>
+#include <functional>
+#include <cstddef>
+
+namespace yajp
+{
+
+// The pieces Serializer and TypedSerializer write values with, appending to `output`. Strings
+// are quoted and escaped, numbers written in their shortest round-trip form.
+void append_json_string(std::string& output, std::string_view string);
+// Throws std::invalid_argument for numbers which are infinite or not a number.
+void append_json_number(std::string& output, double number);
+void append_json_integer(std::string& output, Value::Integer integer);
+
+// Writes Values back to JSON. Numbers are written in their shortest form which parses back to
+// the same double, strings are escaped where JSON requires it and copied in runs otherwise.
+//
+// The output buffer is kept between calls, so a serializer reused for many values stops
+// allocating once the buffer has grown to the largest output, or to the flush size when
+// writing to a sink.
+class Serializer
+{
+  public:
+    struct Options
+    {
+        // One member or element per line, indented by `indent` spaces per level.
+        bool pretty = false;
+        std::size_t indent = 2;
+    };
+
+    // Output for a sink or file descriptor is passed on in chunks of about this size.
+    static constexpr std::size_t FlushSize = 64 * 1024;
+
+    Serializer() = default;
+    explicit Serializer(const Options& options);
+
+    // The returned view is valid until the next call. All functions throw
+    // std::invalid_argument for numbers which are infinite or not a number.
+    std::string_view serialize(const Value& value);
+    // Appends to `output`.
+    void serialize(const Value& value, std::string& output);
+    void serialize(const Value& value, const std::function<void(std::string_view)>& sink);
+    // Throws std::system_error if writing fails.
+    void serialize(const Value& value, int fd);
+
+  private:
+    Options _options;
+    std::string _buffer;
+    const std::function<void(std::string_view)>* _sink = nullptr;
+
+    void write(const Value& value, std::size_t depth);
+    void newline(std::size_t depth);
+    void flush();
+};
+
+}
@@ -0,0 +1,47 @@
+#include "simd.h"
+
+namespace yajp
+{
+
+namespace simd
+{
+
+    static Level detect_level()
+    {
+#if !defined(YAJP_SIMD_X64)
+        return Level::Scalar;
+#elif defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] >= 7)
+        {
+            __cpuid(info, 1);
+            // OSXSAVE and AVX, then check that the OS saves the YMM registers
+            bool os_avx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) &&
+                          (_xgetbv(0) & 0x6) == 0x6;
+            __cpuidex(info, 7, 0);
+            if (os_avx && (info[1] & (1 << 5)))
+            {
+                return Level::AVX2;
+            }
+        }
+        return Level::SSE2;
+#else
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return Level::AVX2;
+        }
+        return Level::SSE2;
+#endif
+    }
+
+    Level detect()
+    {
+        static const Level level = detect_level();
+        return level;
+    }
+
+}
+
+}
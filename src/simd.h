@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+
+// Internal helpers shared by the vectorized scanners.
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define YAJP_SIMD_X64 1
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// Functions using AVX2 intrinsics have to be marked, so that the rest of the library can still
+// run on hosts without AVX2. MSVC does not need (nor support) the attribute.
+#if defined(YAJP_SIMD_X64) && (defined(__GNUC__) || defined(__clang__))
+#define YAJP_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define YAJP_TARGET_AVX2
+#endif
+
+namespace yajp
+{
+
+namespace simd
+{
+
+    enum class Level
+    {
+        Scalar = 0,
+        SSE2 = 1,
+        AVX2 = 2,
+    };
+
+    // Returns the best instruction set supported by both the build and the running CPU.
+    Level detect();
+
+    inline int trailing_zeroes(std::uint64_t bits)
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward64(&index, bits);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(bits);
+#endif
+    }
+
+    inline std::uint64_t clear_lowest_bit(std::uint64_t bits)
+    {
+        return bits & (bits - 1);
+    }
+
+    // Bit i of the result is the xor of bits 0 to i of the input.
+    inline std::uint64_t prefix_xor(std::uint64_t bits)
+    {
+        bits ^= bits << 1;
+        bits ^= bits << 2;
+        bits ^= bits << 4;
+        bits ^= bits << 8;
+        bits ^= bits << 16;
+        bits ^= bits << 32;
+        return bits;
+    }
+
+}
+
+}
@@ -0,0 +1,116 @@
+#include "stats.h"
+#include "value.h"
+#include "serializer.h"
+
+namespace yajp
+{
+
+namespace
+{
+
+Value integer(std::uint64_t value)
+{
+    return Value(static_cast<Value::Integer>(value));
+}
+
+}
+
+std::string ParseStats::to_json() const
+{
+    Value::Object counts;
+    for (std::size_t type = 0; type < Token::TypeCount; type++)
+    {
+        Token::Type token_type = static_cast<Token::Type>(type);
+        counts.emplace(Token::type_to_string(token_type), integer(tokens[type]));
+    }
+    Value::Object object = {
+        {"enabled", Value(Enabled)},
+        {"documents", integer(documents)},
+        {"bytes", integer(bytes)},
+        {"tokens", Value(std::move(counts))},
+        {"max_depth", integer(max_depth)},
+        {"allocations", integer(allocations)},
+        {"allocated_bytes", integer(allocated_bytes)},
+        {"index_time_ns", integer(static_cast<std::uint64_t>(index_time.count()))},
+        {"build_time_ns", integer(static_cast<std::uint64_t>(build_time.count()))},
+    };
+    std::string json;
+    Serializer().serialize(Value(std::move(object)), json);
+    return json;
+}
+
+#if defined(YAJP_STATS)
+namespace stats
+{
+
+    namespace
+    {
+
+        thread_local Allocations totals;
+
+    }
+
+    void* CountingResource::do_allocate(std::size_t bytes, std::size_t alignment)
+    {
+        void* pointer = _upstream->allocate(bytes, alignment);
+        totals.count++;
+        totals.bytes += bytes;
+        return pointer;
+    }
+
+    void CountingResource::do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment)
+    {
+        _upstream->deallocate(pointer, bytes, alignment);
+    }
+
+    bool CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+    {
+        // memory goes back to the upstream directly, so values can be moved between the two
+        // without copying
+        return this == &other || _upstream->is_equal(other);
+    }
+
+    Allocations allocations()
+    {
+        return totals;
+    }
+
+    std::pmr::memory_resource* counted(std::pmr::memory_resource* resource)
+    {
+        static CountingResource heap(std::pmr::new_delete_resource());
+        return resource == std::pmr::new_delete_resource() ? &heap : resource;
+    }
+
+    Scope::Scope(ParseStats& stats, std::size_t size, bool continued)
+        : _stats(stats), _start(std::chrono::steady_clock::now()), _indexed(_start),
+          _allocations(allocations())
+    {
+        if (continued)
+        {
+            _stats.bytes += size;
+        }
+        else
+        {
+            _stats.begin_document(size);
+        }
+    }
+
+    Scope::~Scope()
+    {
+        auto stop = std::chrono::steady_clock::now();
+        _stats.index_time += _indexed - _start;
+        _stats.build_time += stop - _indexed;
+        Allocations now = allocations();
+        _stats.allocations += now.count - _allocations.count;
+        _stats.allocated_bytes += now.bytes - _allocations.bytes;
+    }
+
+    void Scope::indexed()
+    {
+        _indexed = std::chrono::steady_clock::now();
+    }
+
+}
+#endif
+
+}
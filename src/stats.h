@@ -0,0 +1,144 @@
+#pragma once
+#include "token.h"
+#include <array>
+#include <string>
+#include <chrono>
+#include <memory_resource>
+#include <cstddef>
+#include <cstdint>
+
+namespace yajp
+{
+
+// Statistics collected by a Parser over the documents it parsed, see Parser::stats(). They are
+// only collected when the library is built with YAJP_STATS defined (the CMake option of the
+// same name), otherwise every counter stays zero and the instrumentation compiles to nothing.
+struct ParseStats
+{
+#if defined(YAJP_STATS)
+    static constexpr bool Enabled = true;
+#else
+    static constexpr bool Enabled = false;
+#endif
+
+    std::uint64_t documents = 0;
+    // Input bytes, each of them is scanned by the structural index.
+    std::uint64_t bytes = 0;
+    // Indexed by Token::Type.
+    std::array<std::uint64_t, Token::TypeCount> tokens{};
+    // Deepest nesting of containers seen in any document.
+    std::uint64_t max_depth = 0;
+    // Made for Value trees, by parse(), parse_file() and parsing into a Document.
+    std::uint64_t allocations = 0;
+    std::uint64_t allocated_bytes = 0;
+    // Building the structural index, and everything after it: scanning tokens and building the
+    // result, which are interleaved. Push parsing has no index, all of its time is build time.
+    std::chrono::nanoseconds index_time{0};
+    std::chrono::nanoseconds build_time{0};
+
+    void count(const Token& token)
+    {
+        tokens[static_cast<std::size_t>(token.type())]++;
+        if (token.type() == Token::Type::LeftBrace || token.type() == Token::Type::LeftBracket)
+        {
+            _depth++;
+            max_depth = _depth > max_depth ? _depth : max_depth;
+        }
+        else if (token.type() == Token::Type::RightBrace ||
+                 token.type() == Token::Type::RightBracket)
+        {
+            _depth--;
+        }
+    }
+
+    // Starts the next document's nesting count.
+    void begin_document(std::size_t size)
+    {
+        documents++;
+        bytes += size;
+        _depth = 0;
+    }
+
+    // An object with the fields above, times in nanoseconds and token counts by type name.
+    std::string to_json() const;
+
+  private:
+    std::uint64_t _depth = 0;
+};
+
+#if defined(YAJP_STATS)
+namespace stats
+{
+
+    // Forwards to `upstream` and counts what is allocated through it on the calling thread,
+    // for all instances together, see allocations().
+    class CountingResource : public std::pmr::memory_resource
+    {
+      public:
+        explicit CountingResource(std::pmr::memory_resource* upstream) : _upstream(upstream) {}
+
+      private:
+        std::pmr::memory_resource* _upstream;
+
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+    };
+
+    struct Allocations
+    {
+        std::uint64_t count = 0;
+        std::uint64_t bytes = 0;
+    };
+
+    // Totals of all counting resources on the calling thread.
+    Allocations allocations();
+
+    // Counts on top of `resource` if it is the heap, the result lives as long as the program.
+    // Anything else is returned unchanged.
+    std::pmr::memory_resource* counted(std::pmr::memory_resource* resource);
+
+    // Accounts the time and allocations from its construction to its destruction to `stats`,
+    // along with `size` input bytes. Starts a new document unless `continued`, as for the
+    // chunks of push parsing.
+    class Scope
+    {
+      public:
+        Scope(ParseStats& stats, std::size_t size, bool continued = false);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        // Marks the end of building the structural index.
+        void indexed();
+
+      private:
+        ParseStats& _stats;
+        std::chrono::steady_clock::time_point _start;
+        std::chrono::steady_clock::time_point _indexed;
+        Allocations _allocations;
+    };
+
+}
+#else
+namespace stats
+{
+
+    inline std::pmr::memory_resource* counted(std::pmr::memory_resource* resource)
+    {
+        return resource;
+    }
+
+    class Scope
+    {
+      public:
+        Scope(ParseStats&, std::size_t, bool = false) {}
+
+        void indexed() {}
+    };
+
+}
+#endif
+
+}
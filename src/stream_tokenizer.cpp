@@ -0,0 +1,222 @@
+#include "stream_tokenizer.h"
+#include "string_scan.h"
+#include <cctype>
+
+namespace yajp
+{
+
+void StreamTokenizer::feed(const char* data, std::size_t size)
+{
+    // Dropping consumed bytes moves the partial token to the front, which is only done once
+    // that moves fewer bytes than it frees, so long tokens are not copied again and again.
+    if (_consumed * 2 >= _buffer.size())
+    {
+        _buffer.erase(0, _consumed);
+        _consumed = 0;
+    }
+    _buffer.append(data, size);
+    if (_partial.kind != Partial::Kind::None && scan_partial())
+    {
+        return;
+    }
+    _partial = Partial();
+    restart();
+}
+
+StreamTokenizer& StreamTokenizer::operator=(StreamTokenizer&& other) noexcept
+{
+    if (this != &other)
+    {
+        // the tokenizer refers to the other buffer, and is started again by the next feed()
+        _buffer = std::move(other._buffer);
+        _consumed = other._consumed;
+        _tokenizing = false;
+        _partial = other._partial;
+        _finishing = other._finishing;
+        _finished = other._finished;
+        other.reset();
+    }
+    return *this;
+}
+
+void StreamTokenizer::finish()
+{
+    _partial = Partial();
+    _finishing = true;
+    restart();
+}
+
+void StreamTokenizer::reset()
+{
+    _buffer.clear();
+    _consumed = 0;
+    _tokenizing = false;
+    _partial = Partial();
+    _finishing = false;
+    _finished = false;
+}
+
+bool StreamTokenizer::next(Token& token)
+{
+    if (!_tokenizing || _finished)
+    {
+        return false;
+    }
+    Token next = _tokenizer.next();
+    switch (next.type())
+    {
+    case Token::Type::End:
+        if (!_finishing)
+        {
+            _consumed = _buffer.size();
+            _tokenizing = false;
+            return false;
+        }
+        _finished = true;
+        break;
+    case Token::Type::Invalid:
+        if (!_finishing && start_partial(offset(next)))
+        {
+            return false;
+        }
+        _finished = true;
+        break;
+    case Token::Type::Number:
+        // the next chunk might continue the number
+        if (!_finishing && offset(next) + next.value().size() == _buffer.size() &&
+            start_partial(offset(next)))
+        {
+            return false;
+        }
+        break;
+    default:
+        break;
+    }
+    token = next;
+    return true;
+}
+
+void StreamTokenizer::restart()
+{
+    // The tokenizer references the buffer, which ends with the null character its scanners
+    // rely on.
+    _tokenizer.reset(std::string_view(_buffer).substr(_consumed));
+    _tokenizing = true;
+}
+
+std::size_t StreamTokenizer::offset(const Token& token) const
+{
+    return static_cast<std::size_t>(token.value().data() - _buffer.data());
+}
+
+bool StreamTokenizer::start_partial(std::size_t offset)
+{
+    if (offset == _buffer.size())
+    {
+        return false;
+    }
+    _partial = Partial();
+    switch (_buffer[offset])
+    {
+    case '"':
+        _partial.kind = Partial::Kind::String;
+        _partial.scanned = 1;
+        break;
+    case 't':
+    case 'f':
+    case 'n':
+        _partial.kind = Partial::Kind::Keyword;
+        break;
+    default:
+        _partial.kind = Partial::Kind::Number;
+        break;
+    }
+    _consumed = offset;
+    if (scan_partial())
+    {
+        _tokenizing = false;
+        return true;
+    }
+    _partial = Partial();
+    return false;
+}
+
+bool StreamTokenizer::scan_partial()
+{
+    const char* first = _buffer.data() + _consumed;
+    const char* last = _buffer.data() + _buffer.size();
+    const char* c = first + _partial.scanned;
+    switch (_partial.kind)
+    {
+    case Partial::Kind::String:
+        // a string prefix without a closing quote or any invalid byte or escape
+        while (c != last)
+        {
+            if (_partial.hex_digits > 0)
+            {
+                if (!std::isxdigit(static_cast<unsigned char>(*c)))
+                {
+                    return false;
+                }
+                _partial.hex_digits--;
+                c++;
+            }
+            else if (_partial.escape)
+            {
+                if (*c == 'u')
+                {
+                    _partial.hex_digits = 4;
+                }
+                else if (std::string_view(R"("\/bfnrt)").find(*c) == std::string_view::npos)
+                {
+                    return false;
+                }
+                _partial.escape = false;
+                c++;
+            }
+            else
+            {
+                c = find_string_special(c, last);
+                if (c == last)
+                {
+                    break;
+                }
+                if (*c != '\\')
+                {
+                    return false;
+                }
+                _partial.escape = true;
+                c++;
+            }
+        }
+        break;
+    case Partial::Kind::Keyword: {
+        std::string_view keyword = *first == 't' ? "true" : *first == 'f' ? "false" : "null";
+        for (; c != last; c++)
+        {
+            if (static_cast<std::size_t>(c - first) >= keyword.size() ||
+                *c != keyword[c - first])
+            {
+                return false;
+            }
+        }
+        break;
+    }
+    case Partial::Kind::Number:
+        // a number prefix such as `-`, `1.` or `1e+`
+        for (; c != last; c++)
+        {
+            if (std::string_view("0123456789+-.eE").find(*c) == std::string_view::npos)
+            {
+                return false;
+            }
+        }
+        break;
+    case Partial::Kind::None:
+        return false;
+    }
+    _partial.scanned = static_cast<std::size_t>(c - first);
+    return true;
+}
+
+}
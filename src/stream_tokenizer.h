@@ -0,0 +1,79 @@
+#pragma once
+#include "token.h"
+#include "tokenizer.h"
+#include <string>
+#include <string_view>
+#include <utility>
+#include <cstddef>
+
+namespace yajp
+{
+
+// Tokenizes input which arrives in chunks split at arbitrary bytes. Complete tokens are
+// returned as soon as they are available, the bytes of a token cut by the end of a chunk are
+// kept until the next chunk completes it. Memory use is bounded by the largest chunk plus
+// twice the longest token, not by the size of the document, and time is linear in the input
+// however many chunks a token spans.
+class StreamTokenizer
+{
+  public:
+    StreamTokenizer() = default;
+
+    StreamTokenizer(const StreamTokenizer&) = delete;
+    StreamTokenizer& operator=(const StreamTokenizer&) = delete;
+    // Keeps the pending input, but stops tokenizing the current chunk: only move once next()
+    // has returned false.
+    StreamTokenizer(StreamTokenizer&& other) noexcept { *this = std::move(other); }
+    StreamTokenizer& operator=(StreamTokenizer&& other) noexcept;
+
+    void feed(const char* data, std::size_t size);
+    // Marks the end of the input, the remaining tokens and Token::Type::End follow.
+    void finish();
+    void reset();
+
+    // Returns false when no complete token is left and more input is needed. Returned tokens
+    // are valid until the next call to feed(), finish() or reset().
+    bool next(Token& token);
+
+  private:
+    // A token cut off by the end of the buffer, which starts at _consumed. Later chunks are
+    // only scanned from where the previous one ended, so a token spanning many chunks is
+    // scanned once in total.
+    struct Partial
+    {
+        enum class Kind
+        {
+            None,
+            String,
+            Number,
+            Keyword,
+        };
+
+        Kind kind = Kind::None;
+        // Bytes of the token checked so far.
+        std::size_t scanned = 0;
+        // Inside a string: right after a backslash, and hex digits of a \u escape still due.
+        bool escape = false;
+        int hex_digits = 0;
+    };
+
+    std::string _buffer;
+    // Bytes of _buffer which were already returned as tokens.
+    std::size_t _consumed = 0;
+    // Kept between chunks, so its index buffer is reused.
+    Tokenizer _tokenizer;
+    // Whether _tokenizer runs over the bytes after _consumed.
+    bool _tokenizing = false;
+    Partial _partial;
+    bool _finishing = false;
+    bool _finished = false;
+
+    void restart();
+    std::size_t offset(const Token& token) const;
+    // Starts a partial token at `offset` if the rest of the buffer may be the beginning of one.
+    bool start_partial(std::size_t offset);
+    // Returns true while the partial token could still be continued by the next chunk.
+    bool scan_partial();
+};
+
+}
@@ -0,0 +1,99 @@
+#include "string_scan.h"
+
+namespace yajp
+{
+
+namespace
+{
+
+    const char* find_scalar(const char* first, const char* last)
+    {
+        while (first != last && !is_string_special(*first))
+        {
+            first++;
+        }
+        return first;
+    }
+
+#if defined(YAJP_SIMD_X64)
+    const char* find_sse2(const char* first, const char* last)
+    {
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i control = _mm_set1_epi8(0x1F);
+        const __m128i del = _mm_set1_epi8(0x7F);
+        while (last - first >= 16)
+        {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+            __m128i special = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+                _mm_or_si128(
+                    _mm_cmpeq_epi8(_mm_max_epu8(chunk, control), control),
+                    _mm_cmpeq_epi8(chunk, del)));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(special));
+            if (mask != 0)
+            {
+                return first + simd::trailing_zeroes(mask);
+            }
+            first += 16;
+        }
+        return find_scalar(first, last);
+    }
+
+    YAJP_TARGET_AVX2 const char* find_avx2(const char* first, const char* last)
+    {
+        const __m256i quote = _mm256_set1_epi8('"');
+        const __m256i backslash = _mm256_set1_epi8('\\');
+        const __m256i control = _mm256_set1_epi8(0x1F);
+        const __m256i del = _mm256_set1_epi8(0x7F);
+        while (last - first >= 32)
+        {
+            __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+            __m256i special = _mm256_or_si256(
+                _mm256_or_si256(
+                    _mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash)),
+                _mm256_or_si256(
+                    _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, control), control),
+                    _mm256_cmpeq_epi8(chunk, del)));
+            std::uint32_t mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(special));
+            if (mask != 0)
+            {
+                return first + simd::trailing_zeroes(mask);
+            }
+            first += 32;
+        }
+        return find_sse2(first, last);
+    }
+#endif
+
+    using FindFunction = const char* (*)(const char*, const char*);
+
+    FindFunction select(simd::Level level)
+    {
+        switch (level)
+        {
+#if defined(YAJP_SIMD_X64)
+        case simd::Level::AVX2:
+            return find_avx2;
+        case simd::Level::SSE2:
+            return find_sse2;
+#endif
+        default:
+            return find_scalar;
+        }
+    }
+
+}
+
+const char* find_string_special(const char* first, const char* last)
+{
+    static const FindFunction find = select(simd::detect());
+    return find(first, last);
+}
+
+const char* find_string_special(const char* first, const char* last, simd::Level level)
+{
+    return select(level)(first, last);
+}
+
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include "simd.h"
+
+namespace yajp
+{
+
+// Quotes, backslashes and control characters, the same set as std::iscntrl in the C locale plus
+// the two characters with a meaning inside strings.
+inline bool is_string_special(char c)
+{
+    unsigned char u = static_cast<unsigned char>(c);
+    return u == '"' || u == '\\' || u < 0x20 || u == 0x7F;
+}
+
+// Returns the first quote, backslash or control character in [first, last), or last if there
+// is none. Clean runs are skipped a whole vector at a time.
+const char* find_string_special(const char* first, const char* last);
+const char* find_string_special(const char* first, const char* last, simd::Level level);
+
+}
@@ -0,0 +1,357 @@
+#include "structural_index.h"
+#include "utf8.h"
+#include <array>
+#include <cstring>
+
+namespace yajp
+{
+
+namespace
+{
+
+    constexpr std::size_t BlockSize = 64;
+
+    // Bitmasks of one block, bit i describes byte i.
+    struct BlockMasks
+    {
+        std::uint64_t quote;
+        std::uint64_t backslash;
+        std::uint64_t whitespace;
+        std::uint64_t structural;
+    };
+
+    // State carried from one block to the next.
+    class BlockScanner
+    {
+      public:
+        explicit BlockScanner(std::uint32_t* out) : _out(out) {}
+
+        std::uint32_t* out() const { return _out; }
+
+        void scan(const BlockMasks& masks, std::uint32_t offset)
+        {
+            std::uint64_t escaped = find_escaped(masks.backslash);
+            std::uint64_t quote = masks.quote & ~escaped;
+            // includes the opening quote, excludes the closing one
+            std::uint64_t in_string = simd::prefix_xor(quote) ^ _in_string;
+            _in_string = static_cast<std::uint64_t>(static_cast<std::int64_t>(in_string) >> 63);
+
+            std::uint64_t scalar = ~(masks.structural | masks.whitespace | quote) & ~in_string;
+            std::uint64_t scalar_starts = scalar & ~((scalar << 1) | _scalar);
+            _scalar = scalar >> 63;
+
+            std::uint64_t starts =
+                (masks.structural & ~in_string) | (quote & in_string) | scalar_starts;
+            while (starts != 0)
+            {
+                *_out++ = offset + static_cast<std::uint32_t>(simd::trailing_zeroes(starts));
+                starts = simd::clear_lowest_bit(starts);
+            }
+        }
+
+      private:
+        std::uint32_t* _out;
+        std::uint64_t _escaped = 0;
+        std::uint64_t _in_string = 0;
+        std::uint64_t _scalar = 0;
+
+        // Returns the bytes escaped by a backslash, taking runs of backslashes into account.
+        std::uint64_t find_escaped(std::uint64_t backslash)
+        {
+            constexpr std::uint64_t even_bits = 0x5555555555555555ULL;
+            backslash &= ~_escaped;
+            std::uint64_t follows_escape = (backslash << 1) | _escaped;
+            std::uint64_t odd_sequence_starts = backslash & ~even_bits & ~follows_escape;
+            std::uint64_t sequences_starting_on_even_bits = odd_sequence_starts + backslash;
+            _escaped = sequences_starting_on_even_bits < odd_sequence_starts ? 1 : 0;
+            std::uint64_t invert_mask = sequences_starting_on_even_bits << 1;
+            return (even_bits ^ invert_mask) & follows_escape;
+        }
+    };
+
+    enum ByteClass : std::uint8_t
+    {
+        Other = 0,
+        Whitespace = 1,
+        Structural = 2,
+        Quote = 3,
+        Backslash = 4,
+    };
+
+    constexpr std::array<std::uint8_t, 256> make_byte_classes()
+    {
+        std::array<std::uint8_t, 256> classes{};
+        for (unsigned char c : {' ', '\t', '\n', '\r'})
+        {
+            classes[c] = Whitespace;
+        }
+        for (unsigned char c : {'{', '}', '[', ']', ',', ':'})
+        {
+            classes[c] = Structural;
+        }
+        classes['"'] = Quote;
+        classes['\\'] = Backslash;
+        return classes;
+    }
+
+    constexpr std::array<std::uint8_t, 256> byte_classes = make_byte_classes();
+
+    BlockMasks classify_scalar(const char* block)
+    {
+        BlockMasks masks{};
+        for (std::size_t i = 0; i < BlockSize; i++)
+        {
+            std::uint64_t bit = std::uint64_t(1) << i;
+            switch (byte_classes[static_cast<unsigned char>(block[i])])
+            {
+            case Whitespace:
+                masks.whitespace |= bit;
+                break;
+            case Structural:
+                masks.structural |= bit;
+                break;
+            case Quote:
+                masks.quote |= bit;
+                break;
+            case Backslash:
+                masks.backslash |= bit;
+                break;
+            default:
+                break;
+            }
+        }
+        return masks;
+    }
+
+#if defined(YAJP_SIMD_X64)
+    std::uint64_t movemask_sse2(__m128i chunk0, __m128i chunk1, __m128i chunk2, __m128i chunk3)
+    {
+        return static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(chunk0))) |
+               static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(chunk1)))
+                   << 16 |
+               static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(chunk2)))
+                   << 32 |
+               static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(chunk3)))
+                   << 48;
+    }
+
+    BlockMasks classify_sse2(const char* block)
+    {
+        __m128i chunks[4];
+        for (int i = 0; i < 4; i++)
+        {
+            chunks[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * i));
+        }
+        auto eq = [&](int i, char c) { return _mm_cmpeq_epi8(chunks[i], _mm_set1_epi8(c)); };
+        __m128i quote[4], backslash[4], whitespace[4], structural[4];
+        for (int i = 0; i < 4; i++)
+        {
+            quote[i] = eq(i, '"');
+            backslash[i] = eq(i, '\\');
+            whitespace[i] = _mm_or_si128(
+                _mm_or_si128(eq(i, ' '), eq(i, '\t')), _mm_or_si128(eq(i, '\n'), eq(i, '\r')));
+            structural[i] = _mm_or_si128(
+                _mm_or_si128(
+                    _mm_or_si128(eq(i, '{'), eq(i, '}')), _mm_or_si128(eq(i, '['), eq(i, ']'))),
+                _mm_or_si128(eq(i, ','), eq(i, ':')));
+        }
+        BlockMasks masks;
+        masks.quote = movemask_sse2(quote[0], quote[1], quote[2], quote[3]);
+        masks.backslash = movemask_sse2(backslash[0], backslash[1], backslash[2], backslash[3]);
+        masks.whitespace =
+            movemask_sse2(whitespace[0], whitespace[1], whitespace[2], whitespace[3]);
+        masks.structural =
+            movemask_sse2(structural[0], structural[1], structural[2], structural[3]);
+        return masks;
+    }
+
+    YAJP_TARGET_AVX2 inline std::uint64_t movemask_avx2(__m256i low, __m256i high)
+    {
+        return static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(low))) |
+               static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(high)))
+                   << 32;
+    }
+
+    YAJP_TARGET_AVX2 inline __m256i eq_avx2(__m256i chunk, char c)
+    {
+        return _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(c));
+    }
+
+    YAJP_TARGET_AVX2 inline BlockMasks classify_avx2(const char* block)
+    {
+        __m256i chunks[2] = {
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block)),
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32)),
+        };
+        __m256i quote[2], backslash[2], whitespace[2], structural[2];
+        for (int i = 0; i < 2; i++)
+        {
+            __m256i c = chunks[i];
+            quote[i] = eq_avx2(c, '"');
+            backslash[i] = eq_avx2(c, '\\');
+            whitespace[i] = _mm256_or_si256(
+                _mm256_or_si256(eq_avx2(c, ' '), eq_avx2(c, '\t')),
+                _mm256_or_si256(eq_avx2(c, '\n'), eq_avx2(c, '\r')));
+            structural[i] = _mm256_or_si256(
+                _mm256_or_si256(
+                    _mm256_or_si256(eq_avx2(c, '{'), eq_avx2(c, '}')),
+                    _mm256_or_si256(eq_avx2(c, '['), eq_avx2(c, ']'))),
+                _mm256_or_si256(eq_avx2(c, ','), eq_avx2(c, ':')));
+        }
+        BlockMasks masks;
+        masks.quote = movemask_avx2(quote[0], quote[1]);
+        masks.backslash = movemask_avx2(backslash[0], backslash[1]);
+        masks.whitespace = movemask_avx2(whitespace[0], whitespace[1]);
+        masks.structural = movemask_avx2(structural[0], structural[1]);
+        return masks;
+    }
+#endif
+
+    // UTF-8 validation is done block by block in the same pass, while the block is in cache.
+    struct NoValidation
+    {
+        void check(const char*) {}
+        bool finish() const { return true; }
+    };
+
+    struct ScalarValidation
+    {
+        utf8::ScalarValidator validator;
+
+        void check(const char* block) { validator.check(block, BlockSize); }
+        bool finish() const { return validator.finish(); }
+    };
+
+    // The last partial block is copied into a buffer padded with whitespace, which never
+    // produces token starts.
+    template <typename Classify, typename Validation>
+    inline std::uint32_t* scan_blocks(
+        std::string_view input, std::uint32_t* out, Classify classify, Validation& validation)
+    {
+        BlockScanner scanner(out);
+        std::size_t offset = 0;
+        for (; offset + BlockSize <= input.size(); offset += BlockSize)
+        {
+            validation.check(input.data() + offset);
+            scanner.scan(classify(input.data() + offset), static_cast<std::uint32_t>(offset));
+        }
+        if (offset < input.size())
+        {
+            char tail[BlockSize];
+            std::memset(tail, ' ', BlockSize);
+            std::memcpy(tail, input.data() + offset, input.size() - offset);
+            validation.check(tail);
+            scanner.scan(classify(tail), static_cast<std::uint32_t>(offset));
+        }
+        return scanner.out();
+    }
+
+    // Returns the end of the positions, `valid_utf8` is only written when validating.
+    template <typename Classify>
+    std::uint32_t* scan_with(
+        std::string_view input, std::uint32_t* out, Classify classify, bool* valid_utf8)
+    {
+        if (valid_utf8 == nullptr)
+        {
+            NoValidation validation;
+            return scan_blocks(input, out, classify, validation);
+        }
+        ScalarValidation validation;
+        out = scan_blocks(input, out, classify, validation);
+        *valid_utf8 = validation.finish();
+        return out;
+    }
+
+    std::uint32_t* scan_scalar(std::string_view input, std::uint32_t* out, bool* valid_utf8)
+    {
+        return scan_with(input, out, classify_scalar, valid_utf8);
+    }
+
+#if defined(YAJP_SIMD_X64)
+    std::uint32_t* scan_sse2(std::string_view input, std::uint32_t* out, bool* valid_utf8)
+    {
+        return scan_with(input, out, classify_sse2, valid_utf8);
+    }
+
+    // Written out instead of using scan_blocks, since the AVX2 classifier can only be inlined
+    // into functions compiled for AVX2.
+    template <typename Validation>
+    YAJP_TARGET_AVX2 std::uint32_t* scan_avx2(
+        std::string_view input, std::uint32_t* out, Validation& validation)
+    {
+        BlockScanner scanner(out);
+        std::size_t offset = 0;
+        for (; offset + BlockSize <= input.size(); offset += BlockSize)
+        {
+            validation.check(input.data() + offset);
+            scanner.scan(classify_avx2(input.data() + offset), static_cast<std::uint32_t>(offset));
+        }
+        if (offset < input.size())
+        {
+            char tail[BlockSize];
+            std::memset(tail, ' ', BlockSize);
+            std::memcpy(tail, input.data() + offset, input.size() - offset);
+            validation.check(tail);
+            scanner.scan(classify_avx2(tail), static_cast<std::uint32_t>(offset));
+        }
+        return scanner.out();
+    }
+
+    YAJP_TARGET_AVX2 std::uint32_t* scan_avx2(
+        std::string_view input, std::uint32_t* out, bool* valid_utf8)
+    {
+        if (valid_utf8 == nullptr)
+        {
+            NoValidation validation;
+            return scan_avx2(input, out, validation);
+        }
+        utf8::Avx2Validator validation;
+        out = scan_avx2(input, out, validation);
+        *valid_utf8 = validation.finish();
+        return out;
+    }
+#endif
+
+}
+
+void StructuralIndex::build(std::string_view input, bool validate_utf8)
+{
+    build(input, simd::detect(), validate_utf8);
+}
+
+void StructuralIndex::build(std::string_view input, simd::Level level, bool validate_utf8)
+{
+    reserve(input.size());
+    _valid_utf8 = true;
+    bool* valid_utf8 = validate_utf8 ? &_valid_utf8 : nullptr;
+    std::uint32_t* first = _positions.get();
+    std::uint32_t* last = first;
+    switch (level)
+    {
+#if defined(YAJP_SIMD_X64)
+    case simd::Level::AVX2:
+        last = scan_avx2(input, first, valid_utf8);
+        break;
+    case simd::Level::SSE2:
+        last = scan_sse2(input, first, valid_utf8);
+        break;
+#endif
+    default:
+        last = scan_scalar(input, first, valid_utf8);
+        break;
+    }
+    _size = static_cast<std::size_t>(last - first);
+}
+
+void StructuralIndex::reserve(std::size_t input_size)
+{
+    // every byte can start a token, the padding covers the whitespace filled tail block
+    std::size_t capacity = input_size + BlockSize;
+    if (capacity > _capacity)
+    {
+        _positions.reset(new std::uint32_t[capacity]);
+        _capacity = capacity;
+    }
+}
+
+}
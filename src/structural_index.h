@@ -0,0 +1,54 @@
+#pragma once
+#include "simd.h"
+#include <string_view>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace yajp
+{
+
+// Stage one of tokenizing: a single vectorized pass over the input which records the offset of
+// every token start outside of strings, that is structural characters, opening quotes and the
+// first byte of every other run of non-whitespace bytes (numbers and keywords).
+// The tokenizer walks these offsets instead of stepping through whitespace byte by byte.
+class StructuralIndex
+{
+  public:
+    static constexpr std::size_t MaxInputSize = std::numeric_limits<std::uint32_t>::max();
+
+    StructuralIndex() = default;
+
+    // `validate_utf8` checks the input for well-formed UTF-8 in the same pass, see
+    // valid_utf8().
+    void build(std::string_view input, bool validate_utf8 = false);
+    void build(std::string_view input, simd::Level level, bool validate_utf8 = false);
+
+    // False only if validation was asked for and the input is not UTF-8.
+    bool valid_utf8() const { return _valid_utf8; }
+
+    // Empties the index, the buffer is kept for the next build.
+    void clear()
+    {
+        _size = 0;
+        _valid_utf8 = true;
+    }
+
+    const std::uint32_t* begin() const { return _positions.get(); }
+    const std::uint32_t* end() const { return _positions.get() + _size; }
+    std::size_t size() const { return _size; }
+    std::uint32_t operator[](std::size_t i) const { return _positions[i]; }
+
+  private:
+    // Positions are written without bounds checks, so the buffer is sized for the worst case
+    // and kept between builds.
+    std::unique_ptr<std::uint32_t[]> _positions;
+    std::size_t _size = 0;
+    std::size_t _capacity = 0;
+    bool _valid_utf8 = true;
+
+    void reserve(std::size_t input_size);
+};
+
+}
@@ -0,0 +1,265 @@
+#include "tape.h"
+#include <variant>
+#include <stdexcept>
+#include <cstring>
+
+namespace yajp
+{
+
+Element TapeDocument::root() const
+{
+    return Element(this, 0);
+}
+
+void TapeDocument::clear()
+{
+    _tape.clear();
+    _strings.clear();
+    _keys.reset();
+}
+
+std::size_t TapeDocument::skip(std::size_t index) const
+{
+    std::uint64_t word = _tape[index];
+    switch (tag(word))
+    {
+    case '{':
+    case '[':
+        return static_cast<std::size_t>(payload(word) & 0xFFFFFFFF);
+    case 'l':
+    case 'd':
+        return index + 2;
+    default:
+        return index + 1;
+    }
+}
+
+std::string_view TapeDocument::string_at(std::size_t index) const
+{
+    std::uint64_t word = _tape[index];
+    if (tag(word) == 'k')
+    {
+        return _keys->key(static_cast<std::uint32_t>(payload(word)));
+    }
+    std::size_t offset = static_cast<std::size_t>(payload(word));
+    std::uint32_t length;
+    std::memcpy(&length, _strings.data() + offset, sizeof(length));
+    return std::string_view(_strings.data() + offset + sizeof(length), length);
+}
+
+Value::Type Element::type() const
+{
+    switch (tag())
+    {
+    case 't':
+    case 'f':
+        return Value::Type::Bool;
+    case 'l':
+        return Value::Type::Integer;
+    case 'd':
+        return Value::Type::Number;
+    case '"':
+        return Value::Type::String;
+    case '{':
+        return Value::Type::Object;
+    case '[':
+        return Value::Type::Array;
+    default:
+        return Value::Type::Null;
+    }
+}
+
+bool Element::is_null() const
+{
+    return tag() == 'n';
+}
+
+bool Element::get_bool() const
+{
+    if (tag() != 't' && tag() != 'f')
+    {
+        throw std::bad_variant_access();
+    }
+    return tag() == 't';
+}
+
+double Element::get_number() const
+{
+    std::uint64_t bits = _document->_tape[_index + 1];
+    if (tag() == 'l')
+    {
+        return static_cast<double>(static_cast<std::int64_t>(bits));
+    }
+    expect('d');
+    double number;
+    std::memcpy(&number, &bits, sizeof(number));
+    return number;
+}
+
+std::int64_t Element::get_integer() const
+{
+    expect('l');
+    return static_cast<std::int64_t>(_document->_tape[_index + 1]);
+}
+
+std::string_view Element::get_string() const
+{
+    expect('"');
+    return _document->string_at(_index);
+}
+
+ArrayView Element::get_array() const
+{
+    expect('[');
+    return ArrayView(_document, _index);
+}
+
+ObjectView Element::get_object() const
+{
+    expect('{');
+    return ObjectView(_document, _index);
+}
+
+Element Element::operator[](std::string_view key) const
+{
+    return get_object().at(key);
+}
+
+Element Element::operator[](std::size_t index) const
+{
+    return get_array().at(index);
+}
+
+Value Element::to_value(bool integers) const
+{
+    switch (tag())
+    {
+    case 't':
+        return Value(true);
+    case 'f':
+        return Value(false);
+    case 'l':
+        return integers ? Value(get_integer()) : Value(get_number());
+    case 'd':
+        return Value(get_number());
+    case '"':
+        return Value(Value::String(get_string()));
+    case '[': {
+        ArrayView view = get_array();
+        Value::Array array;
+        array.reserve(view.size());
+        for (Element element : view)
+        {
+            array.emplace_back(element.to_value(integers));
+        }
+        return Value(std::move(array));
+    }
+    case '{': {
+        ObjectView view = get_object();
+        Value::Object object;
+        object.reserve(view.size());
+        for (auto [key, value] : view)
+        {
+            object.emplace(key, value.to_value(integers));
+        }
+        return Value(std::move(object));
+    }
+    default:
+        return Value(nullptr);
+    }
+}
+
+void Element::expect(char tag) const
+{
+    if (this->tag() != tag)
+    {
+        throw std::bad_variant_access();
+    }
+}
+
+ArrayView::ArrayView(const TapeDocument* document, std::size_t index)
+    : _document(document), _index(index), _close(document->skip(index) - 1)
+{}
+
+std::size_t ArrayView::size() const
+{
+    std::size_t count = (TapeDocument::payload(_document->_tape[_index]) >> 32);
+    if (count < TapeDocument::CountMask)
+    {
+        return count;
+    }
+    count = 0;
+    for (auto it = begin(); it != end(); ++it)
+    {
+        count++;
+    }
+    return count;
+}
+
+Element ArrayView::at(std::size_t index) const
+{
+    for (Element element : *this)
+    {
+        if (index-- == 0)
+        {
+            return element;
+        }
+    }
+    throw std::out_of_range("ArrayView::at");
+}
+
+ObjectView::ObjectView(const TapeDocument* document, std::size_t index)
+    : _document(document), _index(index), _close(document->skip(index) - 1)
+{}
+
+std::size_t ObjectView::size() const
+{
+    std::size_t count = (TapeDocument::payload(_document->_tape[_index]) >> 32);
+    if (count < TapeDocument::CountMask)
+    {
+        return count;
+    }
+    count = 0;
+    for (auto it = begin(); it != end(); ++it)
+    {
+        count++;
+    }
+    return count;
+}
+
+ObjectView::iterator ObjectView::find(std::string_view key) const
+{
+    std::uint32_t id = _document->_keys ? _document->_keys->find(key) : KeyTable::Missing;
+    if (id != KeyTable::Missing)
+    {
+        std::uint64_t word = TapeDocument::make_word('k', id);
+        for (auto it = begin(); it != end(); ++it)
+        {
+            if (_document->_tape[it._index] == word)
+            {
+                return it;
+            }
+        }
+        return end();
+    }
+    for (auto it = begin(); it != end(); ++it)
+    {
+        if (_document->string_at(it._index) == key)
+        {
+            return it;
+        }
+    }
+    return end();
+}
+
+Element ObjectView::at(std::string_view key) const
+{
+    auto it = find(key);
+    if (it == end())
+    {
+        throw std::out_of_range("ObjectView::at");
+    }
+    return (*it).value;
+}
+
+}
@@ -0,0 +1,210 @@
+#pragma once
+#include "value.h"
+#include "key_table.h"
+#include <vector>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+
+namespace yajp
+{
+
+class Element;
+class ArrayView;
+class ObjectView;
+
+// Read-only document stored as one contiguous tape of 64-bit words plus one string buffer.
+// Each word holds a tag in its top byte and a payload in the remaining bits:
+//
+//     'n', 't', 'f'   null, true and false, no payload
+//     'l', 'd'        integer or double, the raw 64 bits follow in the next word
+//     '"'             string or key, offset of its 32-bit length and bytes in the string buffer
+//     'k'             key interned in the document's KeyTable, its number
+//     '{', '['        index of the word after the matching close in the low 32 bits, number of
+//                     members or elements (saturated at 0xFFFFFF) in the upper 24 bits
+//     '}', ']'        index of the matching open
+//
+// Object members are stored as a key followed by its value. Skipping a container is a single
+// jump, and traversing the whole document is a linear walk over the tape.
+class TapeDocument
+{
+  public:
+    TapeDocument() = default;
+
+    // The document has to be parsed before the root can be accessed.
+    Element root() const;
+
+    void clear();
+
+    std::size_t tape_size() const { return _tape.size(); }
+    std::size_t string_buffer_size() const { return _strings.size(); }
+
+  private:
+    friend class Element;
+    friend class ArrayView;
+    friend class ObjectView;
+    friend class TapeBuilder;
+
+    std::vector<std::uint64_t> _tape;
+    std::string _strings;
+    // Set if the keys are interned.
+    std::shared_ptr<const KeyTable> _keys;
+
+    static constexpr int TagShift = 56;
+    static constexpr std::uint64_t PayloadMask = (std::uint64_t(1) << TagShift) - 1;
+    static constexpr std::uint64_t CountMask = 0xFFFFFF;
+
+    static char tag(std::uint64_t word) { return static_cast<char>(word >> TagShift); }
+    static std::uint64_t payload(std::uint64_t word) { return word & PayloadMask; }
+    static std::uint64_t make_word(char tag, std::uint64_t payload)
+    {
+        return (static_cast<std::uint64_t>(static_cast<unsigned char>(tag)) << TagShift) | payload;
+    }
+
+    // Index of the word after the element starting at `index`.
+    std::size_t skip(std::size_t index) const;
+    std::string_view string_at(std::size_t index) const;
+};
+
+// Lightweight handle to one value on a tape, valid while its document is unchanged.
+class Element
+{
+  public:
+    Element() = default;
+
+    Value::Type type() const;
+
+    bool is_null() const;
+    // These throw std::bad_variant_access if the element has another type.
+    bool get_bool() const;
+    // Works for both Value::Type::Number and Value::Type::Integer.
+    double get_number() const;
+    std::int64_t get_integer() const;
+    std::string_view get_string() const;
+    ArrayView get_array() const;
+    ObjectView get_object() const;
+
+    // Shortcuts for get_object().at(key) and get_array().at(index).
+    Element operator[](std::string_view key) const;
+    Element operator[](std::size_t index) const;
+
+    // Builds a Value out of the element and everything it contains. Integers become
+    // Value::Integer only if `integers` is set, like with Parser::Options::integers.
+    Value to_value(bool integers = false) const;
+
+  private:
+    friend class TapeDocument;
+    friend class ArrayView;
+    friend class ObjectView;
+
+    const TapeDocument* _document = nullptr;
+    std::size_t _index = 0;
+
+    Element(const TapeDocument* document, std::size_t index) : _document(document), _index(index)
+    {}
+
+    char tag() const { return TapeDocument::tag(_document->_tape[_index]); }
+    void expect(char tag) const;
+};
+
+class ArrayView
+{
+  public:
+    class iterator
+    {
+      public:
+        Element operator*() const { return Element(_document, _index); }
+        iterator& operator++()
+        {
+            _index = _document->skip(_index);
+            return *this;
+        }
+        bool operator==(const iterator& other) const { return _index == other._index; }
+        bool operator!=(const iterator& other) const { return _index != other._index; }
+
+      private:
+        friend class ArrayView;
+
+        const TapeDocument* _document;
+        std::size_t _index;
+
+        iterator(const TapeDocument* document, std::size_t index)
+            : _document(document), _index(index)
+        {}
+    };
+
+    iterator begin() const { return iterator(_document, _index + 1); }
+    iterator end() const { return iterator(_document, _close); }
+
+    std::size_t size() const;
+    // Throws std::out_of_range, walks over the preceding elements.
+    Element at(std::size_t index) const;
+
+  private:
+    friend class Element;
+
+    const TapeDocument* _document;
+    // Indices of the open and close words.
+    std::size_t _index;
+    std::size_t _close;
+
+    ArrayView(const TapeDocument* document, std::size_t index);
+};
+
+class ObjectView
+{
+  public:
+    struct Member
+    {
+        std::string_view key;
+        Element value;
+    };
+
+    class iterator
+    {
+      public:
+        Member operator*() const
+        {
+            return {_document->string_at(_index), Element(_document, _index + 1)};
+        }
+        iterator& operator++()
+        {
+            _index = _document->skip(_index + 1);
+            return *this;
+        }
+        bool operator==(const iterator& other) const { return _index == other._index; }
+        bool operator!=(const iterator& other) const { return _index != other._index; }
+
+      private:
+        friend class ObjectView;
+
+        const TapeDocument* _document;
+        std::size_t _index;
+
+        iterator(const TapeDocument* document, std::size_t index)
+            : _document(document), _index(index)
+        {}
+    };
+
+    iterator begin() const { return iterator(_document, _index + 1); }
+    iterator end() const { return iterator(_document, _close); }
+
+    std::size_t size() const;
+    // Linear search over the keys, find returns end() and at throws std::out_of_range if
+    // the key is not present. Keys found in the document's KeyTable are compared by number.
+    iterator find(std::string_view key) const;
+    Element at(std::string_view key) const;
+
+  private:
+    friend class Element;
+
+    const TapeDocument* _document;
+    std::size_t _index;
+    std::size_t _close;
+
+    ObjectView(const TapeDocument* document, std::size_t index);
+};
+
+}
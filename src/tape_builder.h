@@ -0,0 +1,154 @@
+#pragma once
+#include "tape.h"
+#include "key_table.h"
+#include "number.h"
+#include "unescape.h"
+#include <vector>
+#include <string>
+#include <memory>
+#include <string_view>
+#include <cstdint>
+#include <cstring>
+
+namespace yajp
+{
+
+// Reader handler which writes the document onto a tape, see TapeDocument.
+class TapeBuilder
+{
+  public:
+    TapeBuilder() = default;
+    explicit TapeBuilder(TapeDocument& document) : _document(&document) {}
+
+    // Writes to another document, the container stack keeps its capacity. Keys are interned
+    // in `keys` if given, which the document then shares.
+    void reset(TapeDocument& document, std::shared_ptr<KeyTable> keys = nullptr)
+    {
+        _document = &document;
+        _keys = keys.get();
+        _document->_keys = std::move(keys);
+        _containers.clear();
+    }
+
+    bool null()
+    {
+        add('n', 0);
+        return true;
+    }
+
+    bool boolean(bool value)
+    {
+        add(value ? 't' : 'f', 0);
+        return true;
+    }
+
+    bool number(std::string_view literal)
+    {
+        NumberParser::Result number = NumberParser::parse(literal);
+        switch (number.kind)
+        {
+        case NumberParser::Kind::Integer:
+            add('l', 0);
+            _document->_tape.push_back(static_cast<std::uint64_t>(number.integer));
+            return true;
+        case NumberParser::Kind::Double: {
+            std::uint64_t bits;
+            std::memcpy(&bits, &number.number, sizeof(bits));
+            add('d', 0);
+            _document->_tape.push_back(bits);
+            return true;
+        }
+        default:
+            return false;
+        }
+    }
+
+    bool string(std::string_view contents)
+    {
+        add('"', append_string(contents));
+        return true;
+    }
+
+    bool key(std::string_view contents)
+    {
+        // keys are not counted, their values are
+        if (_keys == nullptr)
+        {
+            _document->_tape.push_back(TapeDocument::make_word('"', append_string(contents)));
+            return true;
+        }
+        std::string_view key = contents;
+        if (has_escapes(contents))
+        {
+            _key_buffer.clear();
+            append_unescaped(_key_buffer, contents);
+            key = _key_buffer;
+        }
+        std::uint32_t id = _keys->intern(key);
+        _document->_tape.push_back(
+            id != KeyTable::Missing ? TapeDocument::make_word('k', id)
+                                    : TapeDocument::make_word('"', append_string(contents)));
+        return true;
+    }
+
+    bool start_object() { return open('{'); }
+    bool end_object() { return close('}'); }
+    bool start_array() { return open('['); }
+    bool end_array() { return close(']'); }
+
+  private:
+    struct Container
+    {
+        std::size_t index;
+        std::uint64_t count;
+    };
+
+    TapeDocument* _document = nullptr;
+    std::vector<Container> _containers;
+    KeyTable* _keys = nullptr;
+    // Decoded keys with escapes.
+    std::string _key_buffer;
+
+    void add(char tag, std::uint64_t payload)
+    {
+        if (!_containers.empty())
+        {
+            _containers.back().count++;
+        }
+        _document->_tape.push_back(TapeDocument::make_word(tag, payload));
+    }
+
+    std::uint64_t append_string(std::string_view contents)
+    {
+        std::uint64_t offset = _document->_strings.size();
+        _document->_strings.append(sizeof(std::uint32_t), '\0');
+        append_unescaped(_document->_strings, contents);
+        // the length is only known once the string is decoded
+        std::uint32_t length = static_cast<std::uint32_t>(
+            _document->_strings.size() - offset - sizeof(std::uint32_t));
+        std::memcpy(&_document->_strings[offset], &length, sizeof(length));
+        return offset;
+    }
+
+    bool open(char tag)
+    {
+        add(tag, 0);
+        _containers.push_back({_document->_tape.size() - 1, 0});
+        return true;
+    }
+
+    bool close(char tag)
+    {
+        Container container = _containers.back();
+        _containers.pop_back();
+        _document->_tape.push_back(TapeDocument::make_word(tag, container.index));
+        std::uint64_t count =
+            container.count < TapeDocument::CountMask ? container.count : TapeDocument::CountMask;
+        std::uint64_t& open = _document->_tape[container.index];
+        open = TapeDocument::make_word(
+            TapeDocument::tag(open), (count << 32) | _document->_tape.size());
+        return true;
+    }
+};
+
+}
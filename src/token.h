@@ -1,11 +1,13 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <array>
 #include <cstddef>
 
 namespace yajp
 {
 
+// Tokens do not own their lexemes, they reference the tokenizer's input instead.
 class Token
 {
   public:
@@ -29,11 +31,10 @@ class Token
     };
 
     Token();
-    Token(Type type, const std::string& value);
-    Token(Type type, std::string&& value);
+    Token(Type type, std::string_view value);
 
-    Type type() const;
-    std::string value() const;
+    Type type() const { return _type; }
+    std::string_view value() const { return _value; }
 
     std::string to_string() const;
 
@@ -41,7 +42,7 @@ class Token
 
   private:
     Type _type;
-    std::string _value;
+    std::string_view _value;
 
     static constexpr std::array<const char*, TypeCount> _type_str = {
         "Invalid",
@@ -60,4 +61,9 @@ class Token
     };
 };
 
+constexpr const char* Token::type_to_string(Type type)
+{
+    return _type_str[static_cast<std::array<const char*, TypeCount>::size_type>(type)];
+}
+
 }
@@ -1,23 +1,91 @@
 #include "tokenizer.h"
+#include "string_scan.h"
+#include "utf8.h"
 #include <utility>
 #include <cstddef>
 #include <cctype>
 #include <array>
+#include <algorithm>
 
 namespace yajp
 {
 
-Tokenizer::Tokenizer(const std::string& input) : _input(input), _position(_input.begin())
+Tokenizer::Tokenizer()
+    : _storage(), _input(), _position(_input.begin()), _index(), _next_start(nullptr)
 {}
 
-Tokenizer::Tokenizer(std::string&& input) : _input(std::move(input)), _position(_input.begin())
+Tokenizer::Tokenizer(const std::string& input, bool validate_utf8)
+    : Tokenizer(std::string_view(input), validate_utf8)
 {}
 
-Token Tokenizer::next()
+Tokenizer::Tokenizer(std::string&& input, bool validate_utf8)
+    : _storage(std::move(input)), _input(_storage), _position(_input.begin()), _index(),
+      _next_start(nullptr)
 {
-    while (_position != _input.end() && is_whitespace(*_position))
+    build_index(validate_utf8);
+}
+
+Tokenizer::Tokenizer(std::string_view input, bool validate_utf8)
+    : _storage(), _input(input), _position(_input.begin()), _index(), _next_start(nullptr)
+{
+    build_index(validate_utf8);
+}
+
+void Tokenizer::reset(std::string_view input, bool validate_utf8, std::size_t window)
+{
+    _storage.clear();
+    _input = input;
+    _position = _input.begin();
+    _window = window != 0 && input.size() > window ? std::min(window, StructuralIndex::MaxInputSize)
+                                                    : 0;
+    build_index(validate_utf8);
+}
+
+void Tokenizer::build_index(bool validate_utf8)
+{
+    _valid_utf8 = true;
+    if (_window != 0)
+    {
+        // windows may end inside a character, so they cannot be validated one by one
+        if (validate_utf8)
+        {
+            _valid_utf8 = is_valid_utf8(_input);
+        }
+        index_window(0);
+    }
+    else if (_input.size() <= StructuralIndex::MaxInputSize)
+    {
+        _index.build(_input, validate_utf8);
+        _valid_utf8 = _index.valid_utf8();
+        _index_first = 0;
+        _index_last = _input.size();
+    }
+    else
+    {
+        _index.clear();
+        _index_first = 0;
+        _index_last = 0;
+        if (validate_utf8)
+        {
+            _valid_utf8 = is_valid_utf8(_input);
+        }
+    }
+    _next_start = _index.begin();
+}
+
+void Tokenizer::index_window(std::size_t offset)
+{
+    _index_first = offset;
+    _index_last = std::min(offset + _window, _input.size());
+    _index.build(_input.substr(_index_first, _index_last - _index_first));
+    _next_start = _index.begin();
+}
+
+Token Tokenizer::scan()
+{
+    if (_position != _input.end() && is_whitespace(*_position))
     {
-        _position++;
+        skip_whitespace();
     }
     if (_position == _input.end())
     {
@@ -62,8 +130,52 @@ Token Tokenizer::next()
         return scan_keyword_null(first);
     default:
     error:
-        return Token(Token::Type::Invalid, {});
+        return Token(Token::Type::Invalid, {first, 0});
+    }
+}
+
+void Tokenizer::skip_whitespace()
+{
+    if (_index_last == 0)
+    {
+        while (_position != _input.end() && is_whitespace(*_position))
+        {
+            _position++;
+        }
+        return;
+    }
+    // Everything between whitespace and the next token start is whitespace as well.
+    std::size_t offset = _position - _input.begin();
+    while (true)
+    {
+        while (_next_start != _index.end() && _index_first + *_next_start < offset)
+        {
+            _next_start++;
+        }
+        if (_next_start != _index.end())
+        {
+            _position = _input.begin() + _index_first + *_next_start;
+            return;
+        }
+        if (_index_last == _input.size())
+        {
+            _position = _input.end();
+            return;
+        }
+        // The window has no more token starts: the rest of it is whitespace, or the last
+        // token reached past it, either way the next window starts outside of a string.
+        index_window(std::max(offset, _index_last));
+    }
+}
+
+void Tokenizer::seek(std::size_t offset)
+{
+    _position = _input.begin() + offset;
+    if (_window != 0 && (offset < _index_first || offset >= _index_last))
+    {
+        index_window(offset);
     }
+    _next_start = std::lower_bound(_index.begin(), _index.end(), offset - _index_first);
 }
 
 std::vector<Token> Tokenizer::all()
@@ -71,7 +183,7 @@ std::vector<Token> Tokenizer::all()
     std::vector<Token> tokens;
     if (_input.empty())
     {
-        tokens.emplace_back(Token::Type::End, std::string());
+        tokens.emplace_back(Token::Type::End, std::string_view());
     }
     while (_position != _input.end())
     {
@@ -83,20 +195,28 @@ std::vector<Token> Tokenizer::all()
     }
     if (tokens.back().type() != Token::Type::Invalid && tokens.back().type() != Token::Type::End)
     {
-        tokens.emplace_back(Token::Type::End, std::string());
+        tokens.emplace_back(Token::Type::End, std::string_view());
     }
     return tokens;
 }
 
 Token Tokenizer::scan_number(const char* first)
 {
-    const char* c = first + 1;
+    const char* c = *first == '-' ? first + 1 : first;
+    if (!is_digit(*c))
+    {
+        goto error;
+    }
     // numbers can only have a single zero at the start
-    if ((*first == '0' && *c == '0') || (*first == '-' && *c == '0' && *(c + 1) == '0'))
+    if (*c == '0')
     {
-        return Token(Token::Type::Invalid, {});
+        c++;
+        if (is_digit(*c))
+        {
+            goto error;
+        }
     }
-    while (std::isdigit(static_cast<unsigned char>(*c)))
+    while (is_digit(*c))
     {
         c++;
     }
@@ -104,7 +224,11 @@ Token Tokenizer::scan_number(const char* first)
     if (*c == '.')
     {
         c++;
-        while (std::isdigit(static_cast<unsigned char>(*c)))
+        if (!is_digit(*c))
+        {
+            goto error;
+        }
+        while (is_digit(*c))
         {
             c++;
         }
@@ -117,63 +241,70 @@ Token Tokenizer::scan_number(const char* first)
         {
             c++;
         }
-        while (std::isdigit(static_cast<unsigned char>(*c)))
+        if (!is_digit(*c))
+        {
+            goto error;
+        }
+        while (is_digit(*c))
         {
             c++;
         }
     }
-    std::size_t length = c - first;
-    _position += length - 1;
-    return Token(Token::Type::Number, {first, length});
+    {
+        std::size_t length = c - first;
+        _position += length - 1;
+        return Token(Token::Type::Number, {first, length});
+    }
 error:
-    return Token(Token::Type::Invalid, {});
+    return Token(Token::Type::Invalid, {first, 0});
 }
 
 Token Tokenizer::scan_string(const char* first)
 {
+    const char* last = _input.data() + _input.size();
     const char* c = first + 1;
-    while (*c != '"' && !is_control(*c))
+    while (true)
     {
-        if (*c == '\\')
+        c = find_string_special(c, last);
+        if (c == last || is_control(*c))
+        {
+            // unterminated string or unescaped control character
+            goto error;
+        }
+        if (*c == '"')
         {
             c++;
-            if (*c == 'u')
+            std::size_t length = c - first;
+            _position += length - 1;
+            return Token(Token::Type::String, {first, length});
+        }
+        // *c == '\\'
+        c++;
+        if (*c == 'u')
+        {
+            c++;
+            for (int i = 0; i < 4; i++)
             {
-                c++;
-                for (int i = 0; i < 4; i++)
+                if (!is_hex(*c))
                 {
-                    if (!is_hex(*c))
-                    {
-                        // bad hex escape sequence
-                        goto error;
-                    }
-                    c++;
+                    // bad hex escape sequence
+                    goto error;
                 }
-            }
-            else if (is_escape(*c))
-            {
                 c++;
             }
-            else
-            {
-                // bad escape sequence
-                goto error;
-            }
         }
-        else
+        else if (is_escape(*c))
         {
             c++;
         }
-    }
-    if (*c == '"')
-    {
-        c++;
-        std::size_t length = c - first;
-        _position += length - 1;
-        return Token(Token::Type::String, {first, length});
+        else
+        {
+            // bad escape sequence
+            goto error;
+        }
     }
 error:
-    return Token(Token::Type::Invalid, {});
+    return Token(Token::Type::Invalid, {first, 0});
 }
 
 Token Tokenizer::scan_keyword_true(const char* first)
@@ -197,7 +328,7 @@ Token Tokenizer::scan_keyword_true(const char* first)
     _position += length - 1;
     return Token(Token::Type::KeywordTrue, {first, length});
 error:
-    return Token(Token::Type::Invalid, {});
+    return Token(Token::Type::Invalid, {first, 0});
 }
 
 Token Tokenizer::scan_keyword_false(const char* first)
@@ -226,7 +357,7 @@ Token Tokenizer::scan_keyword_false(const char* first)
     _position += length - 1;
     return Token(Token::Type::KeywordFalse, {first, length});
 error:
-    return Token(Token::Type::Invalid, {});
+    return Token(Token::Type::Invalid, {first, 0});
 }
 
 Token Tokenizer::scan_keyword_null(const char* first)
@@ -250,12 +381,17 @@ Token Tokenizer::scan_keyword_null(const char* first)
     _position += length - 1;
     return Token(Token::Type::KeywordNull, {first, length});
 error:
-    return Token(Token::Type::Invalid, {});
+    return Token(Token::Type::Invalid, {first, 0});
 }
 
 constexpr bool Tokenizer::is_whitespace(char c)
 {
-    return std::isspace(static_cast<unsigned char>(c));
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+constexpr bool Tokenizer::is_digit(char c)
+{
+    return c >= '0' && c <= '9';
 }
 
 constexpr bool Tokenizer::is_control(char c)
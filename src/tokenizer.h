@@ -1,24 +1,104 @@
 #pragma once
 #include "token.h"
+#include "structural_index.h"
+#include "stats.h"
 #include <string>
 #include <vector>
 #include <string_view>
+#include <cstddef>
+#include <cstdint>
 
 namespace yajp
 {
 
+// Produced tokens reference the tokenizer's input, so they are only valid while the input is.
+// Invalid tokens are empty and point at the start of the offending token.
 class Tokenizer
 {
   public:
-    explicit Tokenizer(const std::string& input);
-    explicit Tokenizer(std::string&& input);
+    // Without input until reset() is called.
+    Tokenizer();
+    // The input is referenced, not copied, and has to outlive the tokenizer. `validate_utf8`
+    // checks the input for well-formed UTF-8 while it is indexed, see valid_utf8().
+    explicit Tokenizer(const std::string& input, bool validate_utf8 = false);
+    explicit Tokenizer(std::string&& input, bool validate_utf8 = false);
+    // Tokens may be scanned one byte past the end of a view, so that byte has to be readable
+    // and must not continue a token, e.g. a newline or the terminator of a std::string.
+    explicit Tokenizer(std::string_view input, bool validate_utf8 = false);
+
+    Tokenizer(const Tokenizer&) = delete;
+    Tokenizer& operator=(const Tokenizer&) = delete;
+
+    Token next()
+    {
+#if defined(YAJP_STATS)
+        Token token = scan();
+        if (_stats != nullptr)
+        {
+            _stats->count(token);
+        }
+        return token;
+#else
+        return scan();
+#endif
+    }
 
-    Token next();
     std::vector<Token> all();
 
+    // Starts over on new input, with the same requirements as the string_view constructor.
+    // The index buffer is kept, so a tokenizer reused for documents of similar size does not
+    // allocate.
+    //
+    // Input larger than a non-zero `window` is indexed in windows of that many bytes as
+    // tokenizing reaches them, so the index takes at most about four times `window` bytes
+    // instead of four times the input size, and input beyond StructuralIndex::MaxInputSize is
+    // indexed as well. UTF-8 is then validated in a separate pass before the first window.
+    void reset(std::string_view input, bool validate_utf8 = false, std::size_t window = 0);
+
+    // Counts every token produced into `stats`, if statistics are compiled in.
+    void set_stats(ParseStats* stats)
+    {
+#if defined(YAJP_STATS)
+        _stats = stats;
+#else
+        static_cast<void>(stats);
+#endif
+    }
+
+    // Continues tokenizing at the given byte offset.
+    void seek(std::size_t offset);
+
+    std::string_view input() const { return _input; }
+    // Empty if the input is too large to be indexed. Positions are relative to the start of
+    // the current window when indexing in windows.
+    const StructuralIndex& index() const { return _index; }
+    // False only if validation was asked for and the input is not UTF-8.
+    bool valid_utf8() const { return _valid_utf8; }
+
   private:
-    std::string _input;
-    std::string::iterator _position;
+    std::string _storage;
+    std::string_view _input;
+    std::string_view::iterator _position;
+    // Empty when the input is too large to be indexed.
+    StructuralIndex _index;
+    const std::uint32_t* _next_start;
+    // Window size if the input is indexed in windows, otherwise 0.
+    std::size_t _window = 0;
+    // Byte range of the input the index covers, both 0 if nothing is indexed.
+    std::size_t _index_first = 0;
+    std::size_t _index_last = 0;
+    bool _valid_utf8 = true;
+#if defined(YAJP_STATS)
+    ParseStats* _stats = nullptr;
+#endif
+
+    void build_index(bool validate_utf8);
+    // Indexes the window starting at `offset`, which has to be outside of any string.
+    void index_window(std::size_t offset);
+
+    Token scan();
+
+    void skip_whitespace();
 
     Token scan_number(const char* first);
     Token scan_string(const char* first);
@@ -27,6 +107,7 @@ class Tokenizer
     Token scan_keyword_null(const char* first);
 
     static constexpr bool is_whitespace(char c);
+    static constexpr bool is_digit(char c);
     static constexpr bool is_control(char c);
     static constexpr bool is_escape(char c);
     static constexpr bool is_hex(char c);
@@ -0,0 +1,296 @@
+#pragma once
+#include "binding.h"
+#include "parser_error.h"
+#include "tokenizer.h"
+#include "reader.h"
+#include "value_builder.h"
+#include "number.h"
+#include "unescape.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <bitset>
+#include <charconv>
+#include <type_traits>
+#include <utility>
+
+namespace yajp
+{
+
+// Reads JSON from a tokenizer straight into C++ objects, without building a Value, see
+// Parser::parse_into. Supported are bool, arithmetic types, std::string, std::vector,
+// std::optional (null resets it), maps with std::string keys, Value for parts without a fixed
+// schema, and structs described by a Binding. Members of bound structs which are missing from
+// the input keep their values, unknown keys are skipped, and of repeated keys the first wins,
+// as for Value.
+//
+// Throws ParserError for invalid JSON, values of the wrong type and numbers out of range.
+class TypedReader
+{
+  public:
+    explicit TypedReader(Tokenizer& tokenizer) : _tokenizer(tokenizer) {}
+
+    // Reads the value starting at the next token.
+    template <typename T>
+    void read(T& target)
+    {
+        read(_tokenizer.next(), target);
+    }
+
+    // Whether Value members hold integers as Value::Integer, see Parser::Options::integers.
+    void set_integers(bool integers) { _integers = integers; }
+
+  private:
+    Tokenizer& _tokenizer;
+    // Decoded keys with escapes.
+    std::string _key;
+    // Checks skipped values and builds Value members.
+    Reader _reader;
+    ValueBuilder _builder;
+    bool _integers = false;
+
+    template <typename T>
+    void read(const Token& token, T& target)
+    {
+        if constexpr (std::is_same_v<T, bool>)
+        {
+            if (token.type() != Token::Type::KeywordTrue &&
+                token.type() != Token::Type::KeywordFalse)
+            {
+                mismatch(token);
+            }
+            target = token.type() == Token::Type::KeywordTrue;
+        }
+        else if constexpr (std::is_integral_v<T>)
+        {
+            expect_value(token, Token::Type::Number);
+            const char* last = token.value().data() + token.value().size();
+            auto [end, error] = std::from_chars(token.value().data(), last, target);
+            if (error == std::errc::result_out_of_range)
+            {
+                throw ParserError("Number out of range");
+            }
+            if (end != last)
+            {
+                // a fraction or exponent
+                mismatch(token);
+            }
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            expect_value(token, Token::Type::Number);
+            target = static_cast<T>(NumberParser::parse(token.value()).number);
+        }
+        else if constexpr (std::is_same_v<T, std::string>)
+        {
+            expect_value(token, Token::Type::String);
+            std::string_view contents = token.value().substr(1, token.value().size() - 2);
+            target.clear();
+            append_unescaped(target, contents);
+        }
+        else if constexpr (std::is_same_v<T, Value>)
+        {
+            read_value(token, target);
+        }
+        else if constexpr (typed::is_optional<T>::value)
+        {
+            if (token.type() == Token::Type::KeywordNull)
+            {
+                target.reset();
+                return;
+            }
+            if (!target)
+            {
+                target.emplace();
+            }
+            read(token, *target);
+        }
+        else if constexpr (typed::is_vector<T>::value)
+        {
+            expect_value(token, Token::Type::LeftBracket);
+            target.clear();
+            Token next = _tokenizer.next();
+            if (next.type() == Token::Type::RightBracket)
+            {
+                return;
+            }
+            while (true)
+            {
+                read(next, target.emplace_back());
+                next = _tokenizer.next();
+                if (next.type() == Token::Type::RightBracket)
+                {
+                    return;
+                }
+                expect(next, Token::Type::Comma);
+                next = _tokenizer.next();
+            }
+        }
+        else if constexpr (typed::is_map<T>::value)
+        {
+            target.clear();
+            read_members(token, [&](std::string_view key, const Token& value) {
+                auto [member, inserted] = target.try_emplace(std::string(key));
+                if (inserted)
+                {
+                    read(value, member->second);
+                }
+                else
+                {
+                    skip(value);
+                }
+            });
+        }
+        else if constexpr (is_bound_v<T>)
+        {
+            read_bound(token, target);
+        }
+        else
+        {
+            static_assert(typed::always_false<T>, "Unsupported type, describe it with YAJP_BIND");
+        }
+    }
+
+    template <typename T>
+    void read_bound(const Token& token, T& target)
+    {
+        constexpr std::size_t count = field_count<T>();
+        static constexpr std::array<std::string_view, count> names = field_names<T>();
+        std::bitset<count> seen;
+        // members usually come in the order they are declared in, so the one after the last
+        // match is tried first
+        std::size_t expected = 0;
+        read_members(token, [&](std::string_view key, const Token& value) {
+            std::size_t index = expected < count && names[expected] == key ? expected : count;
+            for (std::size_t i = 0; i < count && index == count; i++)
+            {
+                if (names[i] == key)
+                {
+                    index = i;
+                }
+            }
+            if (index == count || seen[index])
+            {
+                skip(value);
+                return;
+            }
+            seen.set(index);
+            expected = index + 1;
+            read_field(index, value, target, std::make_index_sequence<count>());
+        });
+    }
+
+    // Dispatches to the member at `index`, one comparison per member.
+    template <typename T, std::size_t... I>
+    void read_field(
+        std::size_t index, const Token& value, T& target, std::index_sequence<I...>)
+    {
+        static_cast<void>(
+            ((index == I ? (read(value, target.*(std::get<I>(Binding<T>::fields).member)), true)
+                         : false) ||
+             ...));
+    }
+
+    // Calls `member(key, value token)` for each member of the object starting at `token`,
+    // the member has to consume the whole value.
+    template <typename Member>
+    void read_members(const Token& token, Member&& member)
+    {
+        expect_value(token, Token::Type::LeftBrace);
+        Token next = _tokenizer.next();
+        if (next.type() == Token::Type::RightBrace)
+        {
+            return;
+        }
+        while (true)
+        {
+            expect(next, Token::Type::String);
+            std::string_view key = next.value().substr(1, next.value().size() - 2);
+            if (has_escapes(key))
+            {
+                _key.clear();
+                append_unescaped(_key, key);
+                key = _key;
+            }
+            expect(_tokenizer.next(), Token::Type::Colon);
+            member(key, _tokenizer.next());
+            next = _tokenizer.next();
+            if (next.type() == Token::Type::RightBrace)
+            {
+                return;
+            }
+            expect(next, Token::Type::Comma);
+            next = _tokenizer.next();
+        }
+    }
+
+    // Runs the value starting at `token` through the Reader, reporting it to `handler`.
+    template <typename Handler>
+    void consume(Token token, Handler& handler)
+    {
+        _reader.reset();
+        while (true)
+        {
+            if (_reader.consume(token, handler) == Reader::State::Error)
+            {
+                throw ParserError("Invalid JSON");
+            }
+            if (_reader.done())
+            {
+                return;
+            }
+            token = _tokenizer.next();
+        }
+    }
+
+    void skip(const Token& token)
+    {
+        NullHandler handler;
+        consume(token, handler);
+    }
+
+    void read_value(const Token& token, Value& target)
+    {
+        _builder.reset(_integers, false);
+        consume(token, _builder);
+        target = _builder.take();
+    }
+
+    // For separators and keys.
+    static void expect(const Token& token, Token::Type type)
+    {
+        if (token.type() != type)
+        {
+            throw ParserError("Invalid JSON");
+        }
+    }
+
+    // For the start of a value.
+    static void expect_value(const Token& token, Token::Type type)
+    {
+        if (token.type() != type)
+        {
+            mismatch(token);
+        }
+    }
+
+    [[noreturn]] static void mismatch(const Token& token)
+    {
+        switch (token.type())
+        {
+        case Token::Type::String:
+        case Token::Type::Number:
+        case Token::Type::KeywordTrue:
+        case Token::Type::KeywordFalse:
+        case Token::Type::KeywordNull:
+        case Token::Type::LeftBrace:
+        case Token::Type::LeftBracket:
+            throw ParserError("Unexpected type");
+        default:
+            throw ParserError("Invalid JSON");
+        }
+    }
+};
+
+}
@@ -0,0 +1,198 @@
+#pragma once
+#include "binding.h"
+#include "serializer.h"
+#include "value.h"
+#include <string>
+#include <string_view>
+#include <array>
+#include <variant>
+#include <charconv>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+
+namespace yajp
+{
+
+namespace typed
+{
+
+    // Whether a key can be written between quotes as it is.
+    constexpr bool is_plain_key(std::string_view name)
+    {
+        for (char c : name)
+        {
+            if (c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // The text written before member `I` of a bound struct: the separator unless it is the
+    // first member, then the quoted key and the colon, built at compile time.
+    template <typename T, std::size_t I>
+    struct MemberPrefix
+    {
+        static constexpr std::string_view name = std::get<I>(Binding<T>::fields).name;
+        static_assert(is_plain_key(name), "Keys of bound structs cannot need escapes");
+        static constexpr std::size_t size = name.size() + (I == 0 ? 3 : 4);
+
+        static constexpr std::array<char, size> build()
+        {
+            std::array<char, size> text{};
+            std::size_t i = 0;
+            if (I != 0)
+            {
+                text[i++] = ',';
+            }
+            text[i++] = '"';
+            for (char c : name)
+            {
+                text[i++] = c;
+            }
+            text[i++] = '"';
+            text[i++] = ':';
+            return text;
+        }
+
+        static constexpr std::array<char, size> text = build();
+    };
+
+}
+
+// Writes C++ objects as compact JSON without building a Value first, the counterpart of
+// Parser::parse_into. Supported are bool, arithmetic types, std::string and std::string_view,
+// std::vector (as arrays), std::optional (null when empty), maps with std::string keys,
+// std::variant (its current alternative, std::monostate as null), Value, and structs described
+// by a Binding, whose members are written in the order of their fields.
+//
+// As with Serializer, the output buffer is kept between calls.
+class TypedSerializer
+{
+  public:
+    // The returned view is valid until the next call. Both functions throw
+    // std::invalid_argument for numbers which are infinite or not a number.
+    template <typename T>
+    std::string_view serialize(const T& value)
+    {
+        _buffer.clear();
+        write(_buffer, value);
+        return _buffer;
+    }
+
+    // Appends to `output`.
+    template <typename T>
+    void serialize(const T& value, std::string& output)
+    {
+        write(output, value);
+    }
+
+  private:
+    std::string _buffer;
+    // For Value members.
+    Serializer _serializer;
+
+    template <typename T>
+    void write(std::string& output, const T& value)
+    {
+        if constexpr (std::is_same_v<T, bool>)
+        {
+            output += value ? "true" : "false";
+        }
+        else if constexpr (std::is_integral_v<T>)
+        {
+            char digits[24];
+            std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+            output.append(digits, result.ptr);
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            append_json_number(output, static_cast<double>(value));
+        }
+        else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+        {
+            append_json_string(output, value);
+        }
+        else if constexpr (std::is_same_v<T, Value>)
+        {
+            _serializer.serialize(value, output);
+        }
+        else if constexpr (std::is_same_v<T, std::monostate>)
+        {
+            output += "null";
+        }
+        else if constexpr (typed::is_optional<T>::value)
+        {
+            if (!value)
+            {
+                output += "null";
+                return;
+            }
+            write(output, *value);
+        }
+        else if constexpr (typed::is_variant<T>::value)
+        {
+            std::visit([&](const auto& alternative) { write(output, alternative); }, value);
+        }
+        else if constexpr (typed::is_vector<T>::value)
+        {
+            output += '[';
+            bool first = true;
+            for (const auto& element : value)
+            {
+                if (!first)
+                {
+                    output += ',';
+                }
+                first = false;
+                write(output, element);
+            }
+            output += ']';
+        }
+        else if constexpr (typed::is_map<T>::value)
+        {
+            output += '{';
+            bool first = true;
+            for (const auto& [key, member] : value)
+            {
+                if (!first)
+                {
+                    output += ',';
+                }
+                first = false;
+                append_json_string(output, key);
+                output += ':';
+                write(output, member);
+            }
+            output += '}';
+        }
+        else if constexpr (is_bound_v<T>)
+        {
+            output += '{';
+            write_fields(output, value, std::make_index_sequence<field_count<T>()>());
+            output += '}';
+        }
+        else
+        {
+            static_assert(typed::always_false<T>, "Unsupported type, describe it with YAJP_BIND");
+        }
+    }
+
+    template <typename T, std::size_t... I>
+    void write_fields(std::string& output, const T& value, std::index_sequence<I...>)
+    {
+        (write_field<T, I>(output, value), ...);
+    }
+
+    template <typename T, std::size_t I>
+    void write_field(std::string& output, const T& value)
+    {
+        using Prefix = typed::MemberPrefix<T, I>;
+        output.append(Prefix::text.data(), Prefix::text.size());
+        write(output, value.*(std::get<I>(Binding<T>::fields).member));
+    }
+};
+
+}
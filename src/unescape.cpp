@@ -0,0 +1,114 @@
+#include "unescape.h"
+#include <cstring>
+#include <cstdint>
+
+namespace yajp
+{
+
+namespace
+{
+
+std::uint32_t parse_hex(const char* digits)
+{
+    std::uint32_t value = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        char c = digits[i];
+        std::uint32_t digit = c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10;
+        value = value << 4 | digit;
+    }
+    return value;
+}
+
+char* encode_utf8(std::uint32_t code_point, char* output)
+{
+    if (code_point < 0x80)
+    {
+        *output++ = static_cast<char>(code_point);
+    }
+    else if (code_point < 0x800)
+    {
+        *output++ = static_cast<char>(0xC0 | code_point >> 6);
+        *output++ = static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+    else if (code_point < 0x10000)
+    {
+        *output++ = static_cast<char>(0xE0 | code_point >> 12);
+        *output++ = static_cast<char>(0x80 | (code_point >> 6 & 0x3F));
+        *output++ = static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+    else
+    {
+        *output++ = static_cast<char>(0xF0 | code_point >> 18);
+        *output++ = static_cast<char>(0x80 | (code_point >> 12 & 0x3F));
+        *output++ = static_cast<char>(0x80 | (code_point >> 6 & 0x3F));
+        *output++ = static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+    return output;
+}
+
+}
+
+char* unescape(std::string_view contents, char* output)
+{
+    const char* c = contents.data();
+    const char* last = c + contents.size();
+    while (c != last)
+    {
+        // runs up to the next escape are moved in one go, memchr and memmove are vectorized
+        const char* escape = static_cast<const char*>(std::memchr(c, '\\', last - c));
+        const char* run_end = escape != nullptr ? escape : last;
+        std::memmove(output, c, run_end - c);
+        output += run_end - c;
+        if (escape == nullptr)
+        {
+            break;
+        }
+        c = escape + 2;
+        switch (escape[1])
+        {
+        case 'b':
+            *output++ = '\b';
+            break;
+        case 'f':
+            *output++ = '\f';
+            break;
+        case 'n':
+            *output++ = '\n';
+            break;
+        case 'r':
+            *output++ = '\r';
+            break;
+        case 't':
+            *output++ = '\t';
+            break;
+        case 'u': {
+            std::uint32_t code_point = parse_hex(c);
+            c += 4;
+            if (code_point >= 0xD800 && code_point < 0xDC00 && last - c >= 6 && c[0] == '\\' &&
+                c[1] == 'u')
+            {
+                std::uint32_t low = parse_hex(c + 2);
+                if (low >= 0xDC00 && low < 0xE000)
+                {
+                    code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+                    c += 6;
+                }
+            }
+            if (code_point >= 0xD800 && code_point < 0xE000)
+            {
+                code_point = 0xFFFD;
+            }
+            output = encode_utf8(code_point, output);
+            break;
+        }
+        default:
+            // quote, backslash and slash stand for themselves
+            *output++ = escape[1];
+            break;
+        }
+    }
+    return output;
+}
+
+}
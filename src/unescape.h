@@ -0,0 +1,37 @@
+#pragma once
+#include <string_view>
+#include <cstddef>
+
+namespace yajp
+{
+
+// Whether the contents of a string token contain escape sequences. Strings without any are
+// used as they are.
+inline bool has_escapes(std::string_view contents)
+{
+    return contents.find('\\') != std::string_view::npos;
+}
+
+// Decodes the contents of a string token, without quotes, into UTF-8 and returns the end of
+// the output. The escapes have to be valid, which the tokenizer checks. The output is never
+// longer than the input, so `output` needs room for contents.size() bytes and may even be
+// contents.data() to decode in place. Unpaired surrogates decode to U+FFFD.
+char* unescape(std::string_view contents, char* output);
+
+// Appends the decoded contents to a std::string or std::pmr::string, copying contents without
+// escapes directly.
+template <typename String>
+void append_unescaped(String& output, std::string_view contents)
+{
+    if (!has_escapes(contents))
+    {
+        output.append(contents);
+        return;
+    }
+    std::size_t size = output.size();
+    output.resize(size + contents.size());
+    char* end = unescape(contents, output.data() + size);
+    output.resize(end - output.data());
+}
+
+}
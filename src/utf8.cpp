@@ -0,0 +1,49 @@
+#include "utf8.h"
+
+namespace yajp
+{
+
+namespace
+{
+
+#if defined(YAJP_SIMD_X64)
+    YAJP_TARGET_AVX2 bool validate_avx2(std::string_view input)
+    {
+        utf8::Avx2Validator validator;
+        std::size_t offset = 0;
+        for (; offset + 64 <= input.size(); offset += 64)
+        {
+            validator.check(input.data() + offset);
+        }
+        if (offset < input.size())
+        {
+            // padded with ASCII, which is always valid
+            char tail[64] = {};
+            std::memcpy(tail, input.data() + offset, input.size() - offset);
+            validator.check(tail);
+        }
+        return validator.finish();
+    }
+#endif
+
+}
+
+bool is_valid_utf8(std::string_view input)
+{
+    return is_valid_utf8(input, simd::detect());
+}
+
+bool is_valid_utf8(std::string_view input, simd::Level level)
+{
+#if defined(YAJP_SIMD_X64)
+    if (level == simd::Level::AVX2)
+    {
+        return validate_avx2(input);
+    }
+#endif
+    utf8::ScalarValidator validator;
+    validator.check(input.data(), input.size());
+    return validator.finish();
+}
+
+}
@@ -0,0 +1,261 @@
+#pragma once
+#include "simd.h"
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace yajp
+{
+
+// Returns whether the input is well-formed UTF-8: no overlong encodings, surrogates, code
+// points above U+10FFFF or truncated sequences.
+bool is_valid_utf8(std::string_view input);
+bool is_valid_utf8(std::string_view input, simd::Level level);
+
+namespace utf8
+{
+
+    // Byte by byte validation which can be resumed across chunks of any size. Runs of ASCII
+    // are skipped eight bytes at a time.
+    class ScalarValidator
+    {
+      public:
+        void check(const char* data, std::size_t size)
+        {
+            const unsigned char* c = reinterpret_cast<const unsigned char*>(data);
+            const unsigned char* last = c + size;
+            while (c != last)
+            {
+                if (_remaining == 0)
+                {
+                    while (last - c >= 8 && is_ascii(c))
+                    {
+                        c += 8;
+                    }
+                    if (c == last)
+                    {
+                        break;
+                    }
+                }
+                step(*c++);
+            }
+        }
+
+        // Whether everything checked so far is valid and does not end inside a sequence.
+        bool finish() const { return !_error && _remaining == 0; }
+        // Whether an invalid byte was already found.
+        bool failed() const { return _error; }
+
+        void reset() { *this = ScalarValidator(); }
+
+      private:
+        // Continuation bytes still expected, and the range allowed for the next one.
+        int _remaining = 0;
+        unsigned char _lower = 0x80;
+        unsigned char _upper = 0xBF;
+        bool _error = false;
+
+        static bool is_ascii(const unsigned char* c)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, c, sizeof(word));
+            return (word & 0x8080808080808080ULL) == 0;
+        }
+
+        void step(unsigned char byte)
+        {
+            if (_remaining != 0)
+            {
+                _error |= byte < _lower || byte > _upper;
+                _remaining--;
+                _lower = 0x80;
+                _upper = 0xBF;
+            }
+            else if (byte < 0x80)
+            {
+            }
+            else if (byte < 0xC2)
+            {
+                // a stray continuation byte, or an overlong two byte sequence
+                _error = true;
+            }
+            else if (byte < 0xE0)
+            {
+                _remaining = 1;
+            }
+            else if (byte < 0xF0)
+            {
+                _remaining = 2;
+                // overlong sequences and surrogates
+                _lower = byte == 0xE0 ? 0xA0 : 0x80;
+                _upper = byte == 0xED ? 0x9F : 0xBF;
+            }
+            else if (byte < 0xF5)
+            {
+                _remaining = 3;
+                // overlong sequences and code points above U+10FFFF
+                _lower = byte == 0xF0 ? 0x90 : 0x80;
+                _upper = byte == 0xF4 ? 0x8F : 0xBF;
+            }
+            else
+            {
+                _error = true;
+            }
+        }
+    };
+
+#if defined(YAJP_SIMD_X64)
+    // The lookup table algorithm of Keiser and Lemire ("Validating UTF-8 In Less Than One
+    // Instruction Per Byte"): three table lookups on the nibbles of each byte and its
+    // predecessor flag every invalid two byte combination, longer sequences are checked by
+    // comparing continuation bytes against lead bytes two and three positions back. Blocks of
+    // pure ASCII only check that the previous block did not end inside a sequence.
+    class Avx2Validator
+    {
+      public:
+        YAJP_TARGET_AVX2 Avx2Validator()
+            : _error(_mm256_setzero_si256()), _previous(_mm256_setzero_si256()),
+              _incomplete(_mm256_setzero_si256())
+        {}
+
+        // Checks 64 bytes.
+        YAJP_TARGET_AVX2 void check(const char* block)
+        {
+            __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+            __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+            if (_mm256_movemask_epi8(_mm256_or_si256(low, high)) == 0)
+            {
+                _error = _mm256_or_si256(_error, _incomplete);
+                _previous = _mm256_setzero_si256();
+                _incomplete = _mm256_setzero_si256();
+                return;
+            }
+            check_chunk(low);
+            check_chunk(high);
+        }
+
+        YAJP_TARGET_AVX2 bool finish() const
+        {
+            return _mm256_testz_si256(
+                _mm256_or_si256(_error, _incomplete), _mm256_or_si256(_error, _incomplete));
+        }
+
+      private:
+        __m256i _error;
+        __m256i _previous;
+        __m256i _incomplete;
+
+        // Bits of the error classes, a byte pair is invalid if the three lookups share a bit.
+        static constexpr std::uint8_t TooShort = 1 << 0;
+        static constexpr std::uint8_t TooLong = 1 << 1;
+        static constexpr std::uint8_t Overlong3 = 1 << 2;
+        static constexpr std::uint8_t TooLarge = 1 << 3;
+        static constexpr std::uint8_t Surrogate = 1 << 4;
+        static constexpr std::uint8_t Overlong2 = 1 << 5;
+        static constexpr std::uint8_t TooLarge1000 = 1 << 6;
+        static constexpr std::uint8_t Overlong4 = 1 << 6;
+        static constexpr std::uint8_t TwoContinuations = 1 << 7;
+        static constexpr std::uint8_t Carry = TooShort | TooLong | TwoContinuations;
+
+        // The bytes `N` positions earlier, reaching into the previous chunk.
+        template <int N>
+        YAJP_TARGET_AVX2 static __m256i earlier(__m256i input, __m256i previous)
+        {
+            return _mm256_alignr_epi8(
+                input, _mm256_permute2x128_si256(previous, input, 0x21), 16 - N);
+        }
+
+        YAJP_TARGET_AVX2 static __m256i high_nibbles(__m256i input)
+        {
+            return _mm256_and_si256(_mm256_srli_epi16(input, 4), _mm256_set1_epi8(0x0F));
+        }
+
+        YAJP_TARGET_AVX2 static __m256i lookup(
+            __m256i index,
+            std::uint8_t v0, std::uint8_t v1, std::uint8_t v2, std::uint8_t v3,
+            std::uint8_t v4, std::uint8_t v5, std::uint8_t v6, std::uint8_t v7,
+            std::uint8_t v8, std::uint8_t v9, std::uint8_t v10, std::uint8_t v11,
+            std::uint8_t v12, std::uint8_t v13, std::uint8_t v14, std::uint8_t v15)
+        {
+            __m256i table = _mm256_setr_epi8(
+                v0, v1, v2, v3, v4, v5, v6, v7, v8, v9, v10, v11, v12, v13, v14, v15,
+                v0, v1, v2, v3, v4, v5, v6, v7, v8, v9, v10, v11, v12, v13, v14, v15);
+            return _mm256_shuffle_epi8(table, index);
+        }
+
+        YAJP_TARGET_AVX2 void check_chunk(__m256i input)
+        {
+            __m256i previous1 = earlier<1>(input, _previous);
+            __m256i byte1_high = lookup(
+                high_nibbles(previous1),
+                // 0_______ ________
+                TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong,
+                // 10______ ________
+                TwoContinuations, TwoContinuations, TwoContinuations, TwoContinuations,
+                // 1100____ ________
+                TooShort | Overlong2,
+                // 1101____ ________
+                TooShort,
+                // 1110____ ________
+                TooShort | Overlong3 | Surrogate,
+                // 1111____ ________
+                TooShort | TooLarge | TooLarge1000 | Overlong4);
+            __m256i byte1_low = lookup(
+                _mm256_and_si256(previous1, _mm256_set1_epi8(0x0F)),
+                // ____0000 ________
+                Carry | Overlong3 | Overlong2 | Overlong4,
+                // ____0001 ________
+                Carry | Overlong2,
+                // ____001_ ________
+                Carry, Carry,
+                // ____0100 ________
+                Carry | TooLarge,
+                // ____0101 ________ and ____011_ ________
+                Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000,
+                Carry | TooLarge | TooLarge1000,
+                // ____1___ ________
+                Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000,
+                Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000,
+                Carry | TooLarge | TooLarge1000,
+                // ____1101 ________
+                Carry | TooLarge | TooLarge1000 | Surrogate,
+                Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000);
+            __m256i byte2_high = lookup(
+                high_nibbles(input),
+                // ________ 0_______
+                TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort,
+                // ________ 1000____
+                TooLong | Overlong2 | TwoContinuations | Overlong3 | TooLarge1000 | Overlong4,
+                // ________ 1001____
+                TooLong | Overlong2 | TwoContinuations | Overlong3 | TooLarge,
+                // ________ 101_____
+                TooLong | Overlong2 | TwoContinuations | Surrogate | TooLarge,
+                TooLong | Overlong2 | TwoContinuations | Surrogate | TooLarge,
+                // ________ 11______
+                TooShort, TooShort, TooShort, TooShort);
+            __m256i special = _mm256_and_si256(_mm256_and_si256(byte1_high, byte1_low), byte2_high);
+
+            // the third and fourth byte of a sequence have to be continuations, which the pair
+            // check above reports as two continuations in a row
+            __m256i third = _mm256_subs_epu8(earlier<2>(input, _previous), _mm256_set1_epi8(0x60));
+            __m256i fourth = _mm256_subs_epu8(earlier<3>(input, _previous), _mm256_set1_epi8(0x70));
+            __m256i must_continue = _mm256_and_si256(
+                _mm256_or_si256(third, fourth), _mm256_set1_epi8(static_cast<char>(0x80)));
+            _error = _mm256_or_si256(_error, _mm256_xor_si256(must_continue, special));
+
+            // a sequence starting in the last three bytes continues in the next chunk
+            __m256i maximum = _mm256_setr_epi8(
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1),
+                static_cast<char>(0xC0 - 1));
+            _incomplete = _mm256_subs_epu8(input, maximum);
+            _previous = input;
+        }
+    };
+#endif
+
+}
+
+}
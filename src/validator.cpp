@@ -0,0 +1,298 @@
+#include "validator.h"
+#include "string_scan.h"
+#include <cstddef>
+
+namespace yajp
+{
+
+namespace
+{
+
+enum class State
+{
+    // a value, or the end of the array which was just opened
+    ValueOrClose,
+    Value,
+    // a key, or the end of the object which was just opened
+    KeyOrClose,
+    Key,
+    Colon,
+    // a comma or the end of the innermost container, or of the input
+    AfterValue,
+};
+
+constexpr bool is_whitespace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+constexpr bool is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+constexpr bool is_hex(char c)
+{
+    return is_digit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+// The same grammar as Tokenizer::scan_number, the number has to fill [first, last).
+bool is_number(const char* first, const char* last)
+{
+    const char* c = *first == '-' ? first + 1 : first;
+    if (!is_digit(*c))
+    {
+        return false;
+    }
+    if (*c == '0')
+    {
+        c++;
+    }
+    else
+    {
+        while (is_digit(*c))
+        {
+            c++;
+        }
+    }
+    if (*c == '.')
+    {
+        c++;
+        if (!is_digit(*c))
+        {
+            return false;
+        }
+        while (is_digit(*c))
+        {
+            c++;
+        }
+    }
+    if (*c == 'e' || *c == 'E')
+    {
+        c++;
+        if (*c == '-' || *c == '+')
+        {
+            c++;
+        }
+        if (!is_digit(*c))
+        {
+            return false;
+        }
+        while (is_digit(*c))
+        {
+            c++;
+        }
+    }
+    return c == last;
+}
+
+// The same checks as Tokenizer::scan_string, for the string which starts with the quote at
+// `first` and has to end with the quote at `close`.
+bool is_string(const char* first, const char* close)
+{
+    const char* c = first + 1;
+    if (close - c < 32)
+    {
+        // most strings are short keys and values, for which calling the vectorized scanner
+        // costs more than it saves
+        while (c != close && !is_string_special(*c))
+        {
+            c++;
+        }
+        if (c == close)
+        {
+            return true;
+        }
+    }
+    while (true)
+    {
+        c = find_string_special(c, close + 1);
+        if (*c == '"')
+        {
+            return c == close;
+        }
+        if (*c != '\\')
+        {
+            // a control character
+            return false;
+        }
+        c++;
+        switch (*c)
+        {
+        case '"':
+        case '\\':
+        case '/':
+        case 'b':
+        case 'f':
+        case 'n':
+        case 'r':
+        case 't':
+            c++;
+            break;
+        case 'u':
+            // the closing quote is never part of the escape, nothing past it is read
+            if (close - c < 5 || !is_hex(c[1]) || !is_hex(c[2]) || !is_hex(c[3]) ||
+                !is_hex(c[4]))
+            {
+                return false;
+            }
+            c += 5;
+            break;
+        default:
+            return false;
+        }
+        if (c > close)
+        {
+            return false;
+        }
+    }
+}
+
+// A string token filling [first, last).
+bool is_quoted(const char* first, const char* last)
+{
+    return last - first >= 2 && last[-1] == '"' && is_string(first, last - 1);
+}
+
+bool is_keyword(const char* first, const char* last, std::string_view keyword)
+{
+    return std::string_view(first, last - first) == keyword;
+}
+
+}
+
+bool Validator::check(std::string_view input, const StructuralIndex& index)
+{
+    _stack.clear();
+    std::size_t depth = 0;
+    State state = State::Value;
+    const char* data = input.data();
+    for (std::size_t i = 0; i < index.size(); i++)
+    {
+        const char* first = data + index[i];
+        char c = *first;
+        if (state == State::AfterValue)
+        {
+            if (depth == 0)
+            {
+                return false;
+            }
+            bool object = (_stack[(depth - 1) / 64] >> ((depth - 1) % 64)) & 1;
+            if (c == ',')
+            {
+                state = object ? State::Key : State::Value;
+            }
+            else if (c == (object ? '}' : ']'))
+            {
+                depth--;
+            }
+            else
+            {
+                return false;
+            }
+            continue;
+        }
+        if (state == State::Colon)
+        {
+            if (c != ':')
+            {
+                return false;
+            }
+            state = State::Value;
+            continue;
+        }
+
+        // the token runs up to the next one, but for whitespace
+        auto token_end = [&]()
+        {
+            const char* last = i + 1 < index.size() ? data + index[i + 1] : data + input.size();
+            while (is_whitespace(last[-1]))
+            {
+                last--;
+            }
+            return last;
+        };
+        if (state == State::Key || state == State::KeyOrClose)
+        {
+            if (c == '"' && is_quoted(first, token_end()))
+            {
+                state = State::Colon;
+            }
+            else if (c == '}' && state == State::KeyOrClose)
+            {
+                depth--;
+                state = State::AfterValue;
+            }
+            else
+            {
+                return false;
+            }
+            continue;
+        }
+
+        State expected = state;
+        state = State::AfterValue;
+        switch (c)
+        {
+        case '[':
+        case '{':
+            if (depth % 64 == 0 && depth / 64 == _stack.size())
+            {
+                _stack.push_back(0);
+            }
+            if (c == '{')
+            {
+                _stack[depth / 64] |= std::uint64_t(1) << (depth % 64);
+                state = State::KeyOrClose;
+            }
+            else
+            {
+                _stack[depth / 64] &= ~(std::uint64_t(1) << (depth % 64));
+                state = State::ValueOrClose;
+            }
+            depth++;
+            break;
+        case ']':
+            // only directly after the opening bracket, other closes are handled above
+            if (expected != State::ValueOrClose)
+            {
+                return false;
+            }
+            depth--;
+            break;
+        case '"':
+            if (!is_quoted(first, token_end()))
+            {
+                return false;
+            }
+            break;
+        case 't':
+            if (!is_keyword(first, token_end(), "true"))
+            {
+                return false;
+            }
+            break;
+        case 'f':
+            if (!is_keyword(first, token_end(), "false"))
+            {
+                return false;
+            }
+            break;
+        case 'n':
+            if (!is_keyword(first, token_end(), "null"))
+            {
+                return false;
+            }
+            break;
+        default:
+            if (!is_number(first, token_end()))
+            {
+                return false;
+            }
+            break;
+        }
+    }
+    return state == State::AfterValue && depth == 0;
+}
+
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include "structural_index.h"
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+namespace yajp
+{
+
+// The fast path of Parser::validate(): decides whether the input is one JSON document by
+// walking the structural index instead of producing tokens. Structural characters only drive a
+// grammar state and a bit stack of open containers, strings are checked with the vectorized
+// scanner and numbers and keywords in place. It does not tell where the input goes wrong, the
+// parser tokenizes invalid input again for that.
+class Validator
+{
+  public:
+    Validator() = default;
+
+    // `input` has the same requirements as for Tokenizer's string_view constructor, `index`
+    // has to be built from it. An empty index, as for input too large to be indexed, is
+    // reported as invalid.
+    bool check(std::string_view input, const StructuralIndex& index);
+
+  private:
+    // One bit per open container, set for objects. Kept between calls.
+    std::vector<std::uint64_t> _stack;
+};
+
+}
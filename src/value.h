@@ -1,10 +1,13 @@
 #pragma once
+#include "flat_map.h"
 #include <variant>
 #include <string>
 #include <vector>
-#include <map>
+#include <memory_resource>
 #include <utility>
 #include <cstddef>
+#include <cstdint>
+#include <type_traits>
 
 // std::variant cannot be used in recursive definitions
 
@@ -16,10 +19,15 @@ class Value
   public:
     using Null = std::nullptr_t;
     using Number = double;
-    using String = std::string;
+    // Containers take a memory resource, so that a whole tree can live in one arena (see
+    // Document). Default constructed ones use the default resource, that is the heap.
+    using String = std::pmr::string;
     using Bool = bool;
-    using Object = std::map<std::string, Value>;
-    using Array = std::vector<Value>;
+    // Keeps members in insertion order, see FlatMap.
+    using Object = FlatMap<Value>;
+    using Array = std::pmr::vector<Value>;
+    // Only produced when the parser is asked to keep integers exact.
+    using Integer = std::int64_t;
 
     enum class Type
     {
@@ -29,13 +37,15 @@ class Value
         Bool = 3,
         Object = 4,
         Array = 5,
+        Integer = 6,
     };
 
     Value() = default;
     Value(const Value&) = default;
     Value(Value&&) = default;
 
-    template <typename T>
+    // Not for Value itself, a non-const Value& would otherwise pick this over the copy.
+    template <typename T, typename = std::enable_if_t<!std::is_same_v<std::decay_t<T>, Value>>>
     explicit Value(T&& value) : _value(std::forward<T>(value))
     {}
 
@@ -62,7 +72,7 @@ class Value
     Value& operator=(const Value&) = default;
     Value& operator=(Value&&) = default;
 
-    template <typename T>
+    template <typename T, typename = std::enable_if_t<!std::is_same_v<std::decay_t<T>, Value>>>
     Value& operator=(T&& value)
     {
         _value = std::move(value);
@@ -70,9 +80,7 @@ class Value
     }
 
   private:
-    std::variant<
-        std::nullptr_t, double, std::string, bool, std::map<std::string, Value>, std::vector<Value>>
-        _value;
+    std::variant<Null, Number, String, Bool, Object, Array, Integer> _value;
 };
 
 }
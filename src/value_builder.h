@@ -0,0 +1,203 @@
+#pragma once
+#include "value.h"
+#include "number.h"
+#include "unescape.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <utility>
+#include <memory_resource>
+
+namespace yajp
+{
+
+// Reader handler which builds a Value tree, this is what Parser::parse returns.
+class ValueBuilder
+{
+  public:
+    ValueBuilder() = default;
+
+    // A tree under construction moves along, pending keys and the open containers are
+    // pointed at their new places.
+    ValueBuilder(ValueBuilder&& other) noexcept { *this = std::move(other); }
+
+    ValueBuilder& operator=(ValueBuilder&& other) noexcept
+    {
+        if (this == &other)
+        {
+            return *this;
+        }
+        bool buffered_key = !other._key.empty() && other._key.data() == other._key_buffer.data();
+        bool open_root = !other._depth_stack.empty() && other._depth_stack.front() == &other._root;
+        // moving the root keeps the elements of its containers where they are
+        _root = std::move(other._root);
+        _depth_stack = std::move(other._depth_stack);
+        _key_buffer = std::move(other._key_buffer);
+        _key = buffered_key ? std::string_view(_key_buffer) : other._key;
+        if (open_root)
+        {
+            _depth_stack.front() = &_root;
+        }
+        _discarded = std::move(other._discarded);
+        _integers = other._integers;
+        _copy_keys = other._copy_keys;
+        _resource = other._resource;
+        other.clear();
+        return *this;
+    }
+
+    // `integers` keeps integers exact as Value::Integer. Strings and keys are decoded, keys
+    // without escapes are referenced until their value is added, `copy_keys` copies them
+    // first for input which does not live that long. Every container and string is allocated
+    // from `resource`.
+    void reset(
+        bool integers,
+        bool copy_keys,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+    {
+        _root = nullptr;
+        _depth_stack.clear();
+        _discarded.clear();
+        _key = {};
+        _integers = integers;
+        _copy_keys = copy_keys;
+        _resource = resource;
+    }
+
+    // Moves the result out, after which nothing references the memory resource anymore.
+    Value take()
+    {
+        Value root = std::move(_root);
+        clear();
+        return root;
+    }
+
+    void clear()
+    {
+        _root = nullptr;
+        _depth_stack.clear();
+        _discarded.clear();
+    }
+
+    bool null()
+    {
+        add(Value(nullptr));
+        return true;
+    }
+
+    bool boolean(bool value)
+    {
+        add(Value(value));
+        return true;
+    }
+
+    bool string(std::string_view contents)
+    {
+        if (!has_escapes(contents))
+        {
+            add(Value(Value::String(contents, _resource)));
+            return true;
+        }
+        Value::String string(_resource);
+        append_unescaped(string, contents);
+        add(Value(std::move(string)));
+        return true;
+    }
+
+    bool number(std::string_view literal)
+    {
+        NumberParser::Result number = NumberParser::parse(literal);
+        switch (number.kind)
+        {
+        case NumberParser::Kind::Integer:
+            add(_integers ? Value(number.integer) : Value(number.number));
+            return true;
+        case NumberParser::Kind::Double:
+            add(Value(number.number));
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    bool key(std::string_view contents)
+    {
+        if (has_escapes(contents))
+        {
+            _key_buffer.clear();
+            append_unescaped(_key_buffer, contents);
+            contents = _key_buffer;
+        }
+        else if (_copy_keys)
+        {
+            _key_buffer.assign(contents);
+            contents = _key_buffer;
+        }
+        _key = contents;
+        return true;
+    }
+
+    bool start_object()
+    {
+        _depth_stack.push_back(add(Value(Value::Object(_resource))));
+        return true;
+    }
+
+    bool start_array()
+    {
+        _depth_stack.push_back(add(Value(Value::Array(_resource))));
+        return true;
+    }
+
+    bool end_object()
+    {
+        _depth_stack.pop_back();
+        return true;
+    }
+
+    bool end_array()
+    {
+        _depth_stack.pop_back();
+        return true;
+    }
+
+  private:
+    Value _root;
+    // This stack is used to reference nested structures.
+    std::vector<Value*> _depth_stack;
+    // A key is only pending until its value starts, so there is never more than one.
+    std::string_view _key;
+    std::string _key_buffer;
+    // Values of repeated keys, which are built and dropped since the first member wins.
+    // References to a deque's elements survive growing it.
+    std::deque<Value> _discarded;
+    bool _integers = false;
+    bool _copy_keys = false;
+    std::pmr::memory_resource* _resource = std::pmr::get_default_resource();
+
+    // Returns the added value, the pointer stays valid while it is the innermost container.
+    Value* add(Value&& value)
+    {
+        if (_depth_stack.empty())
+        {
+            _root = std::move(value);
+            return &_root;
+        }
+        Value* parent = _depth_stack.back();
+        if (parent->type() == Value::Type::Array)
+        {
+            return &parent->get<Value::Array>().emplace_back(std::move(value));
+        }
+        // the key is constructed in place, with the object's allocator, and `value` is left
+        // alone if the key is taken
+        auto [member, inserted] = parent->get<Value::Object>().emplace(_key, std::move(value));
+        if (!inserted)
+        {
+            return &_discarded.emplace_back(std::move(value));
+        }
+        return &member->second;
+    }
+};
+
+}
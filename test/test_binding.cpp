@@ -0,0 +1,156 @@
+#include "parser.h"
+#include "binding.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <optional>
+#include <cstdint>
+
+using namespace yajp;
+
+struct Location
+{
+    double lat = 0;
+    double lon = 0;
+};
+
+struct User
+{
+    std::uint64_t id = 0;
+    std::string name;
+    bool verified = false;
+    std::optional<Location> location;
+    std::vector<std::string> tags;
+    std::map<std::string, int> counters;
+    Value extra;
+    int untouched = 7;
+};
+
+YAJP_BIND(Location, lat, lon)
+YAJP_BIND(User, id, name, verified, location, tags, counters, extra, untouched)
+
+struct Renamed
+{
+    float value = 0;
+    std::int8_t small = 0;
+};
+
+template <>
+struct yajp::Binding<Renamed>
+{
+    static constexpr auto fields =
+        std::make_tuple(field("the value", &Renamed::value), field("s", &Renamed::small));
+};
+
+template <typename T>
+bool throws(const std::string& test_data, const char* message)
+{
+    T target;
+    try
+    {
+        Parser().parse_into(test_data, target);
+    }
+    catch (const ParserError& error)
+    {
+        return std::string(error.what()) == message;
+    }
+    return false;
+}
+
+int main()
+{
+    bool failed_any = false;
+    Parser parser;
+
+    std::string test_data = R"({
+        "unknown": {"deep": [1, {"x": null}], "s": "é"},
+        "name": "Ada \"L\"",
+        "id": 18446744073709551615,
+        "verified": true,
+        "location": {"lon": 13.405, "lat": 52.52, "alt": 34},
+        "tags": ["a", "b\n"],
+        "counters": {"x": 1, "y": -2, "x": 3},
+        "extra": {"any": [true, 1.5]},
+        "name": "ignored"
+    })";
+    User user;
+    parser.parse_into(test_data, user);
+    if (user.id != 18446744073709551615ULL || user.name != "Ada \"L\"" || !user.verified ||
+        user.untouched != 7)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 1.\n";
+    }
+
+    if (!user.location || user.location->lat != 52.52 || user.location->lon != 13.405 ||
+        user.tags != std::vector<std::string>{"a", "b\n"} ||
+        user.counters != std::map<std::string, int>{{"x", 1}, {"y", -2}})
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 2.\n";
+    }
+
+    if (user.extra.type() != Value::Type::Object ||
+        user.extra.get<Value::Object>().at("any").get<Value::Array>().size() != 2)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 3.\n";
+    }
+
+    // null resets optionals, the rest of the struct is reused
+    parser.parse_into(R"({"location": null, "tags": []})", user);
+    if (user.location || !user.tags.empty() || user.name != "Ada \"L\"")
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 4.\n";
+    }
+
+    Renamed renamed;
+    std::vector<Renamed> list;
+    parser.parse_into(R"([{"the value": 0.5, "s": -128}, {"the value": 2}])", list);
+    parser.parse_into(R"({"s": 5})", renamed);
+    if (list.size() != 2 || list[0].value != 0.5f || list[0].small != -128 ||
+        list[1].value != 2.0f || renamed.small != 5)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 5.\n";
+    }
+
+    if (!throws<Renamed>(R"({"s": 128})", "Number out of range") ||
+        !throws<Renamed>(R"({"s": 1.5})", "Unexpected type") ||
+        !throws<User>(R"({"id": -1})", "Unexpected type") ||
+        !throws<User>(R"({"name": 1})", "Unexpected type") ||
+        !throws<User>(R"({"tags": {}})", "Unexpected type") ||
+        !throws<User>(R"([])", "Unexpected type"))
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 6.\n";
+    }
+
+    // skipped values are still checked
+    if (!throws<User>(R"({"unknown": [1 2]})", "Invalid JSON") ||
+        !throws<User>(R"({"unknown": {"a"}})", "Invalid JSON") ||
+        !throws<User>(R"({"id": 1,})", "Invalid JSON") ||
+        !throws<User>(R"({"id" 1})", "Invalid JSON") ||
+        !throws<User>(R"({"id": 1} [])", "Invalid JSON") ||
+        !throws<User>(R"({"id": 1)", "Invalid JSON"))
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 7.\n";
+    }
+
+    // Value members follow the parser's options
+    Parser::Options integers;
+    integers.integers = true;
+    user = User();
+    Parser(integers).parse_into(std::string(R"({"extra": [3, 0.5]})"), user);
+    if (user.extra.get<Value::Array>().at(0).type() != Value::Type::Integer ||
+        user.extra.get<Value::Array>().at(1).type() != Value::Type::Number)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 8.\n";
+    }
+
+    return failed_any ? -1 : 0;
+}
@@ -0,0 +1,82 @@
+#include "flat_map.h"
+#include <string>
+#include <string_view>
+#include <iostream>
+#include <cstddef>
+
+using namespace yajp;
+
+bool test(std::size_t member_count)
+{
+    FlatMap<int> map;
+    for (std::size_t i{0}; i < member_count; i++)
+    {
+        // reverse order, so that insertion order differs from sorted order
+        std::string key = "key" + std::to_string(member_count - i);
+        if (!map.emplace(key, static_cast<int>(i)).second)
+        {
+            return false;
+        }
+    }
+    if (map.size() != member_count || (member_count > 0 && map.emplace("key1", -1).second))
+    {
+        return false;
+    }
+    std::size_t i{0};
+    for (const auto& [key, value] : map)
+    {
+        if (std::string_view(key) != "key" + std::to_string(member_count - i) ||
+            value != static_cast<int>(i))
+        {
+            return false;
+        }
+        i++;
+    }
+    for (i = 0; i < member_count; i++)
+    {
+        std::string key = "key" + std::to_string(member_count - i);
+        if (!map.contains(key) || map.at(key) != static_cast<int>(i))
+        {
+            return false;
+        }
+    }
+    if (map.contains("missing") || map.find("missing") != map.end())
+    {
+        return false;
+    }
+    if (member_count > 0)
+    {
+        std::string removed = "key" + std::to_string(member_count);
+        if (map.erase(removed) != 1 || map.contains(removed) || map.size() != member_count - 1)
+        {
+            return false;
+        }
+        for (i = 1; i < member_count; i++)
+        {
+            if (map.at("key" + std::to_string(member_count - i)) != static_cast<int>(i))
+            {
+                return false;
+            }
+        }
+    }
+    map["new"] = 42;
+    return map.at("new") == 42 && (map.end() - 1)->first == "new";
+}
+
+int main()
+{
+    bool failed_any = false;
+    int test_case = 1;
+    // below, at and well above the index threshold
+    for (std::size_t member_count : {0, 1, 15, 16, 17, 100, 1000})
+    {
+        if (!test(member_count))
+        {
+            failed_any = true;
+            std::cerr << "Failed test case " << test_case << ".\n";
+        }
+        test_case++;
+    }
+
+    return failed_any ? -1 : 0;
+}
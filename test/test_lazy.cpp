@@ -0,0 +1,116 @@
+#include "parser.h"
+#include "lazy.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+
+using namespace yajp;
+
+bool throws_parser_error(const LazyDocument& document)
+{
+    try
+    {
+        document.materialize();
+    }
+    catch (const ParserError&)
+    {
+        return true;
+    }
+    return false;
+}
+
+int main()
+{
+    bool failed_any = false;
+    Parser parser;
+    std::string test_data = R"(
+{
+  "skipped": {"deep": [[[{"a": "}]"}]]], "text": "[{\"quoted\"}]"},
+  "user": {"id": 42, "name": "Bret", "tags": ["x", "y"], "ok": true, "none": null},
+  "price": 21.37
+}
+    )";
+    LazyDocument document = parser.parse_lazy(test_data);
+    LazyValue root = document.root();
+
+    if (root.type() != Value::Type::Object || root.size() != 3)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 1.\n";
+    }
+
+    LazyValue user = root["user"];
+    if (user["id"].get_integer() != 42 || user["name"].get_string() != "Bret" ||
+        !user["ok"].get_bool() || !user["none"].is_null() || root["price"].get_number() != 21.37)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 2.\n";
+    }
+
+    if (user["tags"][1].get_string() != "y" || user["tags"].size() != 2 || root.find("missing"))
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 3.\n";
+    }
+
+    std::vector<std::string_view> keys;
+    root.for_each([&](std::string_view key, LazyValue) { keys.push_back(key); });
+    std::vector<Value::String> elements;
+    user["tags"].for_each([&](LazyValue value) { elements.push_back(value.get_string()); });
+    if (keys != std::vector<std::string_view>{"skipped", "user", "price"} ||
+        elements != std::vector<Value::String>{"x", "y"})
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 4.\n";
+    }
+
+    // malformed subtrees are only reported when they are reached
+    test_data = R"({"bad": [1, 2 3, {]], "good": 5})";
+    LazyDocument partial = parser.parse_lazy(test_data);
+    if (partial.root()["good"].get_number() != 5 || !throws_parser_error(partial))
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 5.\n";
+    }
+
+    const char* invalid_cases[] = {"", "   ", "[1, 2", R"({"a": 1} 2)", "[1,]", "[01]"};
+    for (const char* invalid : invalid_cases)
+    {
+        if (!throws_parser_error(parser.parse_lazy(invalid)))
+        {
+            failed_any = true;
+            std::cerr << "Failed test case 6 with input `" << invalid << "`.\n";
+        }
+    }
+
+    bool threw = false;
+    try
+    {
+        root["user"]["id"]["nested"];
+    }
+    catch (const ParserError&)
+    {
+        threw = true;
+    }
+    if (!threw)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 7.\n";
+    }
+
+    test_data = R"({"a\u0062": "\u00e9", "\/": 1})";
+    LazyDocument escaped = parser.parse_lazy(test_data);
+    std::vector<std::string> decoded_keys;
+    escaped.root().for_each([&](std::string_view key, LazyValue)
+                            { decoded_keys.emplace_back(key); });
+    if (escaped.root()["ab"].get_string() != "\xc3\xa9" || !escaped.root().find("/") ||
+        decoded_keys != std::vector<std::string>{"ab", "/"})
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 8.\n";
+    }
+
+    return failed_any ? -1 : 0;
+}
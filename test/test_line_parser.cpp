@@ -0,0 +1,101 @@
+#include "line_parser.h"
+#include <string>
+#include <vector>
+#include <utility>
+#include <iostream>
+
+using namespace yajp;
+
+// Returns the line reported by the LineError, 0 if there was none.
+std::size_t error_line(LineParser& parser, const std::string& input)
+{
+    try
+    {
+        parser.parse(input);
+    }
+    catch (const LineError& error)
+    {
+        return error.line();
+    }
+    return 0;
+}
+
+int main()
+{
+    bool failed_any = false;
+
+    std::string test_data;
+    for (int i = 0; i < 1000; i++)
+    {
+        test_data += R"({"id": )" + std::to_string(i) + R"(, "tags": ["a", "b"]})";
+        test_data += i % 7 == 0 ? "\r\n\n" : "\n";
+    }
+    test_data += "[1000]";
+
+    // chunks of a few lines each, spread over several threads
+    LineParser::Options options;
+    options.threads = 4;
+    options.chunk_size = 100;
+    LineParser parser(options);
+    std::vector<Value> values = parser.parse(test_data);
+    bool ordered = values.size() == 1001;
+    for (std::size_t i = 0; ordered && i < 1000; i++)
+    {
+        const Value& id = values[i].get<Value::Object>().at("id");
+        ordered = id.get<Value::Number>() == static_cast<double>(i);
+    }
+    if (!ordered || values.back().get<Value::Array>()[0].get<Value::Number>() != 1000)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 1.\n";
+    }
+
+    std::vector<std::pair<std::size_t, double>> lines;
+    std::string small_data = "1\n\n  2  \n[3]\n\n";
+    LineParser(options).parse(
+        small_data,
+        [&](std::size_t line, Value&& value)
+        {
+            double number = value.type() == Value::Type::Number
+                                ? value.get<Value::Number>()
+                                : value.get<Value::Array>()[0].get<Value::Number>();
+            lines.emplace_back(line, number);
+        });
+    if (lines != std::vector<std::pair<std::size_t, double>>{{1, 1}, {3, 2}, {4, 3}})
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 2.\n";
+    }
+
+    test_data.insert(test_data.rfind("{\"id\": 500,"), "{\"broken\": }\n");
+    // 500 values before it, and a blank line after the 72 of them whose id is a multiple of 7
+    std::size_t expected = 500 + 72 + 1;
+    if (error_line(parser, test_data) != expected)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 3.\n";
+    }
+
+    struct Case
+    {
+        std::string input;
+        std::size_t line;
+    };
+    Case invalid_cases[] = {
+        {"1\n2 3\n", 2},
+        {"1\n[2,\n3]\n", 2},
+        {"1\n\n[2\n", 3},
+        {"{}\n{\"a\": tru}\n", 2},
+        {"\"unterminated\n", 1},
+    };
+    for (const Case& invalid : invalid_cases)
+    {
+        if (error_line(parser, invalid.input) != invalid.line)
+        {
+            failed_any = true;
+            std::cerr << "Failed test case 4 with input `" << invalid.input << "`.\n";
+        }
+    }
+
+    return failed_any ? -1 : 0;
+}
@@ -0,0 +1,86 @@
+#include "mapped_file.h"
+#include "parser.h"
+#include <string>
+#include <fstream>
+#include <cstdio>
+#include <iostream>
+#include <system_error>
+
+using namespace yajp;
+
+std::string write_file(const std::string& name, const std::string& content)
+{
+    std::string path = "test_mapped_file_" + name + ".json";
+    std::ofstream(path, std::ios::binary) << content;
+    return path;
+}
+
+int main()
+{
+    bool failed_any = false;
+    Parser parser;
+
+    // the last token ends exactly at a page boundary, so the lookahead reads the padding
+    for (std::size_t size : {4096, 16384, 65536})
+    {
+        std::string content(size - 5, ' ');
+        content += "12345";
+        std::string path = write_file("page", content);
+        MappedFile file(path);
+        if (file.data() != content || file.data().data()[file.size()] != '\0' ||
+            parser.parse_file(path).get<Value::Number>() != 12345)
+        {
+            failed_any = true;
+            std::cerr << "Failed test case 1 with size " << size << ".\n";
+        }
+        std::remove(path.c_str());
+    }
+
+    std::string content = R"({"key": [true, null, "value"]})";
+    std::string path = write_file("object", content);
+    Value value = parser.parse_file(path);
+    MappedFile moved = MappedFile(path);
+    MappedFile file(std::move(moved));
+    if (value.get<Value::Object>().at("key").get<Value::Array>()[2].get<Value::String>() !=
+            "value" ||
+        file.data() != content || moved.size() != 0)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 2.\n";
+    }
+    std::remove(path.c_str());
+
+    path = write_file("empty", "");
+    bool threw = false;
+    try
+    {
+        parser.parse_file(path);
+    }
+    catch (const ParserError&)
+    {
+        threw = true;
+    }
+    if (!threw || MappedFile(path).size() != 0)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 3.\n";
+    }
+    std::remove(path.c_str());
+
+    threw = false;
+    try
+    {
+        MappedFile missing("test_mapped_file_missing.json");
+    }
+    catch (const std::system_error&)
+    {
+        threw = true;
+    }
+    if (!threw)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 4.\n";
+    }
+
+    return failed_any ? -1 : 0;
+}
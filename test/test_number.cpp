@@ -0,0 +1,109 @@
+#include "number.h"
+#include <string>
+#include <iostream>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+
+using namespace yajp;
+
+bool test_double(const std::string& test_data, double test_target)
+{
+    NumberParser::Result result = NumberParser::parse(test_data);
+    // compare the representation, so that signed zeros and rounding errors are caught
+    return result.kind == NumberParser::Kind::Double &&
+           std::memcmp(&result.number, &test_target, sizeof(double)) == 0;
+}
+
+bool test_integer(const std::string& test_data, std::int64_t test_target)
+{
+    NumberParser::Result result = NumberParser::parse(test_data);
+    return result.kind == NumberParser::Kind::Integer && result.integer == test_target &&
+           result.number == static_cast<double>(test_target);
+}
+
+bool test_invalid(const std::string& test_data)
+{
+    return NumberParser::parse(test_data).kind == NumberParser::Kind::Invalid;
+}
+
+int main()
+{
+    bool failed_any = false;
+    const double infinity = std::numeric_limits<double>::infinity();
+
+    struct DoubleCase
+    {
+        const char* text;
+        double value;
+    };
+    const DoubleCase double_cases[] = {
+        {"21.37", 21.37},
+        {"-0.5", -0.5},
+        {"-0", -0.0},
+        {"0.0", 0.0},
+        {"1e3", 1000.0},
+        {"1E+3", 1000.0},
+        {"25e-2", 0.25},
+        {"0.000001", 0.000001},
+        {"3.141592653589793", 3.141592653589793},
+        {"9007199254740993.0", 9007199254740992.0},
+        {"123456789012345678901234567890", 1.2345678901234568e29},
+        {"0.1000000000000000055511151231257827021181583404541015625", 0.1},
+        {"2.2250738585072014e-308", 2.2250738585072014e-308},
+        {"4.9406564584124654e-324", 4.9406564584124654e-324},
+        {"1.7976931348623157e308", 1.7976931348623157e308},
+        {"1e400", infinity},
+        {"-1e400", -infinity},
+        {"1e-400", 0.0},
+        {"18446744073709551616", 18446744073709551616.0},
+    };
+    int test_case = 1;
+    for (const auto& [text, value] : double_cases)
+    {
+        if (!test_double(text, value))
+        {
+            failed_any = true;
+            std::cerr << "Failed test case " << test_case << " (" << text << ").\n";
+        }
+        test_case++;
+    }
+
+    struct IntegerCase
+    {
+        const char* text;
+        std::int64_t value;
+    };
+    const IntegerCase integer_cases[] = {
+        {"0", 0},
+        {"1234", 1234},
+        {"-42", -42},
+        {"9007199254740993", 9007199254740993},
+        {"9223372036854775807", std::numeric_limits<std::int64_t>::max()},
+        {"-9223372036854775808", std::numeric_limits<std::int64_t>::min()},
+    };
+    for (const auto& [text, value] : integer_cases)
+    {
+        if (!test_integer(text, value))
+        {
+            failed_any = true;
+            std::cerr << "Failed test case " << test_case << " (" << text << ").\n";
+        }
+        test_case++;
+    }
+
+    const char* invalid_cases[] = {
+        "", "-", "01", "-01", "1.", ".5", "1e", "1e+", "+1", "1.5x", "0x10", "1,5", "--1",
+    };
+    for (const char* text : invalid_cases)
+    {
+        if (!test_invalid(text))
+        {
+            failed_any = true;
+            std::cerr << "Failed test case " << test_case << " (" << text << ").\n";
+        }
+        test_case++;
+    }
+
+    return failed_any ? -1 : 0;
+}
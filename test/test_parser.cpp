@@ -3,6 +3,8 @@
 #include <iostream>
 #include <string>
 #include <algorithm>
+#include <vector>
+#include <utility>
 #include <limits>
 #include <cstddef>
 #include <cmath>
@@ -30,13 +32,20 @@ bool equals(const Value& first, const Value& second)
     }
     case Value::Type::String: {
         const auto& first_string = first.get<Value::Type::String>();
-        const auto& second_string = first.get<Value::Type::String>();
+        const auto& second_string = second.get<Value::Type::String>();
         if (first_string != second_string)
         {
             return false;
         }
         break;
     }
+    case Value::Type::Integer: {
+        if (first.get<Value::Type::Integer>() != second.get<Value::Type::Integer>())
+        {
+            return false;
+        }
+        break;
+    }
     case Value::Type::Number: {
         auto first_number = first.get<Value::Type::Number>();
         auto second_number = second.get<Value::Type::Number>();
@@ -91,18 +100,53 @@ bool equals(const Value& first, const Value& second)
     return true;
 }
 
-bool test(const std::string& test_data, const Value& test_target)
+bool test(const std::string& test_data, const Value& test_target, Parser::Options options = {})
 {
-    Parser parser;
-    Value value = parser.parse(test_data);
-    if (!equals(value, test_target))
-    {
-        return false;
-    }
-    value = parser.parse_lazy(test_data);
-    if (!equals(value, test_target))
+    // every entry point, on both engines where they apply
+    for (Parser::Engine engine : {Parser::Engine::Reader, Parser::Engine::Descent})
     {
-        return false;
+        options.engine = engine;
+        Parser parser(options);
+        Value value = parser.parse(test_data);
+        if (!equals(value, test_target))
+        {
+            return false;
+        }
+        value = parser.parse_parallel(test_data, 3);
+        if (!equals(value, test_target))
+        {
+            return false;
+        }
+        value = parser.parse_lazy(test_data).materialize();
+        if (!equals(value, test_target))
+        {
+            return false;
+        }
+        Document document;
+        parser.parse(test_data, document);
+        if (!equals(document.root(), test_target))
+        {
+            return false;
+        }
+        TapeDocument tape;
+        parser.parse(test_data, tape);
+        if (!equals(tape.root().to_value(options.integers), test_target))
+        {
+            return false;
+        }
+        // every split point, as well as a few chunk sizes
+        for (std::size_t chunk_size : {1, 2, 3, 7})
+        {
+            for (std::size_t i{0}; i < test_data.size(); i += chunk_size)
+            {
+                parser.feed(std::string_view(test_data).substr(i, chunk_size));
+            }
+            value = parser.finish();
+            if (!equals(value, test_target))
+            {
+                return false;
+            }
+        }
     }
     return true;
 }
@@ -248,5 +292,208 @@ int main()
         std::cerr << "Failed test case 14.\n";
     }
 
+    Parser::Options integers;
+    integers.integers = true;
+    test_data = R"([9007199254740993, -1, 0.5, -0])";
+    test_target = Value::Array({
+        Value(Value::Integer(9007199254740993)),
+        Value(Value::Integer(-1)),
+        Value(0.5),
+        Value(-0.0),
+    });
+    if (!test(test_data, test_target, integers))
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 15.\n";
+    }
+
+    bool threw = false;
+    try
+    {
+        Parser parser;
+        parser.feed(R"({"key": tr)");
+        parser.feed(R"(ue, "other": tx)");
+        parser.finish();
+    }
+    catch (const ParserError&)
+    {
+        threw = true;
+    }
+    if (!threw)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 16.\n";
+    }
+
+    // escapes are decoded to UTF-8, including surrogate pairs, lone surrogates become U+FFFD
+    test_data = R"({"k\"ey\u00e9": ["a\\b\/c\n\t", "\u20ac\ud83d\ude00", "\ud800x", "plain"]})";
+    test_target = Value::Object({
+        {"k\"ey\xc3\xa9",
+         Value(Value::Array({
+             Value("a\\b/c\n\t"),
+             Value("\xe2\x82\xac\xf0\x9f\x98\x80"),
+             Value("\xef\xbf\xbdx"),
+             Value("plain"),
+         }))},
+    });
+    if (!test(test_data, test_target))
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 17.\n";
+    }
+
+    // split points have to skip commas and brackets inside strings and nested values
+    test_data = "[";
+    for (int i = 0; i < 200; i++)
+    {
+        test_data += i == 0 ? "" : ", ";
+        test_data += R"({"id": )" + std::to_string(i) + R"(, "text": "a, ] \"b, [", "c": [1, 2]})";
+    }
+    test_data += "]";
+    Parser parser;
+    if (!equals(parser.parse_parallel(test_data, 4), parser.parse(test_data)) ||
+        parser.parse_parallel(test_data).get<Value::Array>().size() != 200)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 18.\n";
+    }
+
+    const char* invalid_arrays[] = {"[1,,2]", "[,1]", "[1,2,]", "[1, 2] 3", R"([1, {"a": ]}, 2])",
+                                    "[1,2}", "[[1},2]"};
+    for (const char* invalid : invalid_arrays)
+    {
+        threw = false;
+        try
+        {
+            parser.parse_parallel(invalid, 2);
+        }
+        catch (const ParserError&)
+        {
+            threw = true;
+        }
+        if (!threw)
+        {
+            failed_any = true;
+            std::cerr << "Failed test case 19 with input `" << invalid << "`.\n";
+        }
+    }
+
+    // a parser and documents reused across documents of different sizes, and past an error
+    Document document;
+    TapeDocument tape;
+    const std::string small = R"({"a": [true, "\u00e9"]})";
+    const std::string inputs[] = {test_data, small, "[1, 2", test_data, small};
+    for (const std::string& input : inputs)
+    {
+        Value expected;
+        try
+        {
+            expected = Parser().parse(input);
+        }
+        catch (const ParserError&)
+        {
+            threw = false;
+            try
+            {
+                parser.parse(input, document);
+            }
+            catch (const ParserError&)
+            {
+                threw = true;
+            }
+            if (!threw)
+            {
+                failed_any = true;
+                std::cerr << "Failed test case 20.\n";
+            }
+            continue;
+        }
+        parser.parse(input, document);
+        parser.parse(input, tape);
+        if (!equals(parser.parse(input), expected) || !equals(document.root(), expected) ||
+            !equals(tape.root().to_value(false), expected))
+        {
+            failed_any = true;
+            std::cerr << "Failed test case 20.\n";
+        }
+    }
+
+    // both engines reject the same documents and keep the first of repeated keys
+    const char* invalid_documents[] = {
+        "", "[1 2]", "{\"a\" 1}", "{\"a\": 1,}", "{1: 2}", "[1]]", "{\"a\": [}", "[-]", "nul",
+        "[1, 2", "{\"a\": 1} {}", "[\"\n\"]",
+    };
+    for (Parser::Engine engine : {Parser::Engine::Reader, Parser::Engine::Descent})
+    {
+        Parser::Options options;
+        options.engine = engine;
+        Parser engine_parser(options);
+        for (const char* invalid : invalid_documents)
+        {
+            threw = false;
+            try
+            {
+                engine_parser.parse(invalid);
+            }
+            catch (const ParserError&)
+            {
+                threw = true;
+            }
+            if (!threw)
+            {
+                failed_any = true;
+                std::cerr << "Failed test case 21 with input `" << invalid << "`.\n";
+            }
+        }
+        test_target = Value::Object({
+            {"a", Value(Value::Array({Value(1.0)}))},
+            {"b", Value(true)},
+        });
+        if (!equals(engine_parser.parse(R"({"a": [1], "b": true, "a": {"a": [2], "a": 3}})"),
+                    test_target))
+        {
+            failed_any = true;
+            std::cerr << "Failed test case 21.\n";
+        }
+    }
+
+    // tokens spanning many chunks are only scanned once, this takes seconds if each chunk
+    // scans the string from its start again
+    std::string long_text;
+    for (std::size_t i = 0; long_text.size() < 8 * 1024 * 1024; i++)
+    {
+        long_text += i % 64 == 0 ? "\\u00e9\\n" : "some text ";
+    }
+    test_data = R"([{"long": ")" + long_text + R"("}, 12345678, true])";
+    Parser stream_parser;
+    for (std::size_t i = 0; i < test_data.size(); i += 4096)
+    {
+        stream_parser.feed(std::string_view(test_data).substr(i, 4096));
+    }
+    if (!equals(stream_parser.finish(), Parser().parse(test_data)))
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 22.\n";
+    }
+
+    // moved parsers keep their options and a document half pushed through feed()
+    std::vector<Parser> parsers;
+    parsers.push_back(Parser(integers));
+    parsers.emplace_back();
+    test_data = R"({"key": [1, "text", {"nested": 2}], "last": -3})";
+    parsers[0].feed(std::string_view(test_data).substr(0, 20));
+    Parser moved = std::move(parsers[0]);
+    parsers.emplace_back();
+    moved.feed(std::string_view(test_data).substr(20));
+    parsers[0] = std::move(moved);
+    Value moved_result = parsers[0].finish();
+    if (!equals(moved_result, Parser(integers).parse(test_data)) ||
+        equals(moved_result, Parser().parse(test_data)) ||
+        !equals(parsers[2].parse("[1]"), Parser().parse("[1]")))
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 23.\n";
+    }
+
     return failed_any ? -1 : 0;
 }
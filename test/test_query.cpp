@@ -0,0 +1,97 @@
+#include "parser.h"
+#include "query.h"
+#include <string>
+#include <vector>
+#include <optional>
+#include <iostream>
+#include <stdexcept>
+
+using namespace yajp;
+
+bool check(const std::optional<Value>& result, double number)
+{
+    return result && result->type() == Value::Type::Number &&
+           result->get<Value::Number>() == number;
+}
+
+bool check(const std::optional<Value>& result, const char* string)
+{
+    return result && result->type() == Value::Type::String &&
+           result->get<Value::String>() == string;
+}
+
+int main()
+{
+    bool failed_any = false;
+    Parser parser;
+    std::string test_data = R"(
+{
+  "skipped": {"deep": [[[{"id": "}]"}]]]},
+  "user": {"id": 42, "name": "Bret", "a/b": 1, "m~n": 2},
+  "items": [{"price": 1.5}, {"price": 2.5}],
+  "": 3
+}
+    )";
+    Query query({"/user/id", "/items/1/price", "/user/a~1b", "/user/m~0n", "/", "/missing",
+                 "/items/2", "/items/-", "/user/id", "/user/name/0"});
+    std::vector<std::optional<Value>> results = parser.extract(test_data, query);
+    if (results.size() != query.size() || !check(results[0], 42) || !check(results[1], 2.5) ||
+        !check(results[2], 1) || !check(results[3], 2) || !check(results[4], 3) || results[5] ||
+        results[6] || results[7] || !check(results[8], 42) || results[9])
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 1.\n";
+    }
+
+    results = parser.extract(test_data, Query({"", "/user/name"}));
+    if (!results[0] || results[0]->type() != Value::Type::Object || !check(results[1], "Bret"))
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 2.\n";
+    }
+
+    // the walk stops once every pointer is resolved, so what follows is never looked at
+    test_data = R"({"a": {"b": [0, 1], "c": }, "d": [})";
+    results = parser.extract(test_data, Query({"/a/b/1"}));
+    if (!check(results[0], 1))
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 3.\n";
+    }
+
+    bool threw = false;
+    try
+    {
+        parser.extract(test_data, Query({"/a/b/1", "/d"}));
+    }
+    catch (const ParserError&)
+    {
+        threw = true;
+    }
+    if (!threw)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 4.\n";
+    }
+
+    const char* invalid_pointers[] = {"a", "/a~", "/a~2"};
+    for (const char* invalid : invalid_pointers)
+    {
+        threw = false;
+        try
+        {
+            Query query({invalid});
+        }
+        catch (const std::invalid_argument&)
+        {
+            threw = true;
+        }
+        if (!threw)
+        {
+            failed_any = true;
+            std::cerr << "Failed test case 5 with pointer `" << invalid << "`.\n";
+        }
+    }
+
+    return failed_any ? -1 : 0;
+}
@@ -0,0 +1,98 @@
+#include "parser.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <iostream>
+
+using namespace yajp;
+
+// Records every event as a line of text.
+class RecordingHandler
+{
+  public:
+    std::vector<std::string> events;
+    std::size_t stop_after = static_cast<std::size_t>(-1);
+
+    bool null() { return record("null"); }
+    bool boolean(bool value) { return record(value ? "true" : "false"); }
+    bool number(std::string_view literal) { return record("number " + std::string(literal)); }
+    bool string(std::string_view contents) { return record("string " + std::string(contents)); }
+    bool key(std::string_view contents) { return record("key " + std::string(contents)); }
+    bool start_object() { return record("{"); }
+    bool end_object() { return record("}"); }
+    bool start_array() { return record("["); }
+    bool end_array() { return record("]"); }
+
+  private:
+    bool record(std::string event)
+    {
+        events.push_back(std::move(event));
+        return events.size() < stop_after;
+    }
+};
+
+int main()
+{
+    bool failed_any = false;
+    std::string test_data =
+        R"({"a": [1, -2.5e3, "x\"y"], "b": {"c": null}, "d": true, "e": false})";
+    std::vector<std::string> test_target = {
+        "{",
+        "key a",
+        "[",
+        "number 1",
+        "number -2.5e3",
+        "string x\\\"y",
+        "]",
+        "key b",
+        "{",
+        "key c",
+        "null",
+        "}",
+        "key d",
+        "true",
+        "key e",
+        "false",
+        "}",
+    };
+    Parser parser;
+    RecordingHandler handler;
+    if (!parser.parse(test_data, handler) || handler.events != test_target)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 1.\n";
+    }
+
+    handler = RecordingHandler();
+    handler.stop_after = 3;
+    if (parser.parse(test_data, handler) || handler.events.size() != 3)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 2.\n";
+    }
+
+    const char* invalid_cases[] = {
+        R"({"a" 1})", R"([1,])", R"({"a": 1,})", R"([1 2])", "[", "]", "", "[01]", "[1.]",
+        R"({"a": tru})", "[] []",
+    };
+    for (const char* invalid : invalid_cases)
+    {
+        handler = RecordingHandler();
+        bool threw = false;
+        try
+        {
+            parser.parse(invalid, handler);
+        }
+        catch (const ParserError&)
+        {
+            threw = true;
+        }
+        if (!threw)
+        {
+            failed_any = true;
+            std::cerr << "Failed test case 3 with input `" << invalid << "`.\n";
+        }
+    }
+
+    return failed_any ? -1 : 0;
+}
@@ -0,0 +1,135 @@
+#include "serializer.h"
+#include "parser.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <limits>
+#include <iostream>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+using namespace yajp;
+
+int main()
+{
+    bool failed_any = false;
+    Parser parser;
+    Serializer serializer;
+
+    std::string test_data = R"({"key1": [1, 2.5, -0.001, 1e+300], "key2": {"a": null, "b": true},)"
+                            R"( "key3": [], "key4": {}, "key5": "text", "key6": false})";
+    std::string target = R"({"key1":[1,2.5,-0.001,1e+300],"key2":{"a":null,"b":true},)"
+                         R"("key3":[],"key4":{},"key5":"text","key6":false})";
+    if (serializer.serialize(parser.parse(test_data)) != target)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 1.\n";
+    }
+
+    Serializer::Options options;
+    options.pretty = true;
+    target = "{\n"
+             "  \"a\": [\n"
+             "    1,\n"
+             "    {}\n"
+             "  ],\n"
+             "  \"b\": []\n"
+             "}";
+    if (Serializer(options).serialize(parser.parse(R"({"a": [1, {}], "b": []})")) != target)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 2.\n";
+    }
+
+    // shortest representations which still parse back to the same double
+    Value::Array numbers({
+        Value(0.1),
+        Value(1.0 / 3),
+        Value(std::numeric_limits<double>::denorm_min()),
+        Value(std::numeric_limits<double>::max()),
+        Value(Value::Integer(-9007199254740993)),
+    });
+    target = "[0.1,0.3333333333333333,5e-324,1.7976931348623157e+308,-9007199254740993]";
+    std::string output = "prefix ";
+    serializer.serialize(Value(numbers), output);
+    if (output != "prefix " + target)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 3.\n";
+    }
+
+    Value::String string("quote \" backslash \\ newline \n tab \t control \x01 del \x7f end");
+    target = R"("quote \" backslash \\ newline \n tab \t control \u0001 del \u007f end")";
+    if (serializer.serialize(Value(string)) != target ||
+        Parser().parse(std::string(serializer.serialize(Value(string))))
+                .get<Value::String>() != string)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 4.\n";
+    }
+
+    // large enough to be flushed to the sink in several chunks
+    Value::Array array;
+    for (int i = 0; i < 20000; i++)
+    {
+        array.emplace_back(Value::String("element"));
+    }
+    Value large(std::move(array));
+    std::string expected(serializer.serialize(large));
+    std::string collected;
+    std::size_t chunks = 0;
+    serializer.serialize(
+        large,
+        [&](std::string_view chunk)
+        {
+            collected += chunk;
+            chunks++;
+        });
+    if (collected != expected || chunks < 2)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 5.\n";
+    }
+
+#ifndef _WIN32
+    int pipe_fds[2];
+    if (pipe(pipe_fds) != 0)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 6.\n";
+    }
+    else
+    {
+        serializer.serialize(parser.parse(R"({"fd": [true]})"), pipe_fds[1]);
+        close(pipe_fds[1]);
+        char buffer[64];
+        ssize_t size = read(pipe_fds[0], buffer, sizeof(buffer));
+        close(pipe_fds[0]);
+        if (size < 0 || std::string_view(buffer, size) != R"({"fd":[true]})")
+        {
+            failed_any = true;
+            std::cerr << "Failed test case 6.\n";
+        }
+    }
+#endif
+
+    bool threw = false;
+    try
+    {
+        serializer.serialize(Value(std::numeric_limits<double>::infinity()));
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    if (!threw)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 7.\n";
+    }
+
+    return failed_any ? -1 : 0;
+}
@@ -0,0 +1,72 @@
+#include "parser.h"
+#include "stats.h"
+#include <iostream>
+#include <string>
+
+using namespace yajp;
+
+int main()
+{
+    bool failed_any = false;
+    const std::string test_data = R"({"a": [1, 2, {"b": null}], "c": "text"})";
+    Parser parser;
+    Value value = parser.parse(test_data);
+    Document document;
+    parser.parse(test_data, document);
+    parser.feed(test_data.substr(0, 10));
+    parser.feed(test_data.substr(10));
+    parser.finish();
+    const ParseStats& stats = parser.stats();
+
+    // the export is JSON in any build
+    Value exported = Parser().parse(stats.to_json());
+    const Value::Object& object = exported.get<Value::Object>();
+    if (object.at("enabled").get<Value::Bool>() != ParseStats::Enabled ||
+        object.at("tokens").get<Value::Object>().size() != Token::TypeCount)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 1.\n";
+    }
+
+    if (!ParseStats::Enabled)
+    {
+        if (stats.documents != 0 || stats.bytes != 0 || stats.allocations != 0)
+        {
+            failed_any = true;
+            std::cerr << "Failed test case 2.\n";
+        }
+        return failed_any ? -1 : 0;
+    }
+
+    auto tokens = [&](Token::Type type) { return stats.tokens[static_cast<std::size_t>(type)]; };
+    if (stats.documents != 3 || stats.bytes != 3 * test_data.size() || stats.max_depth != 3)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 3.\n";
+    }
+
+    if (tokens(Token::Type::String) != 3 * 4 || tokens(Token::Type::Number) != 3 * 2 ||
+        tokens(Token::Type::LeftBrace) != 3 * 2 || tokens(Token::Type::End) != 3 ||
+        tokens(Token::Type::Invalid) != 0)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 4.\n";
+    }
+
+    // both the heap tree and the one in the document's arena are counted
+    if (stats.allocations < 2 * 4 || stats.allocated_bytes == 0 ||
+        stats.index_time.count() + stats.build_time.count() == 0)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 5.\n";
+    }
+
+    parser.reset_stats();
+    if (parser.stats().documents != 0 || parser.stats().max_depth != 0)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 6.\n";
+    }
+
+    return failed_any ? -1 : 0;
+}
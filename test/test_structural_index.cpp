@@ -0,0 +1,121 @@
+#include "structural_index.h"
+#include "simd.h"
+#include <vector>
+#include <string>
+#include <string_view>
+#include <iostream>
+#include <random>
+#include <cstddef>
+#include <cstdint>
+
+using namespace yajp;
+
+// Byte by byte definition of the token starts found by the structural index.
+std::vector<std::uint32_t> reference_starts(std::string_view input)
+{
+    std::vector<std::uint32_t> starts;
+    bool in_string = false;
+    bool escaped = false;
+    bool in_scalar = false;
+    for (std::size_t i{0}; i < input.size(); i++)
+    {
+        char c = input[i];
+        bool is_escaped = escaped;
+        escaped = c == '\\' && !is_escaped;
+        if (in_string)
+        {
+            if (c == '"' && !is_escaped)
+            {
+                in_string = false;
+            }
+            in_scalar = false;
+            continue;
+        }
+        if (c == '"' && !is_escaped)
+        {
+            starts.push_back(static_cast<std::uint32_t>(i));
+            in_string = true;
+            in_scalar = false;
+        }
+        else if (c == '{' || c == '}' || c == '[' || c == ']' || c == ',' || c == ':')
+        {
+            starts.push_back(static_cast<std::uint32_t>(i));
+            in_scalar = false;
+        }
+        else if (c == ' ' || c == '\t' || c == '\n' || c == '\r')
+        {
+            in_scalar = false;
+        }
+        else
+        {
+            if (!in_scalar)
+            {
+                starts.push_back(static_cast<std::uint32_t>(i));
+            }
+            in_scalar = true;
+        }
+    }
+    return starts;
+}
+
+bool test(std::string_view test_data)
+{
+    std::vector<std::uint32_t> test_target = reference_starts(test_data);
+    for (int level = 0; level <= static_cast<int>(simd::detect()); level++)
+    {
+        StructuralIndex index;
+        index.build(test_data, static_cast<simd::Level>(level));
+        if (std::vector<std::uint32_t>(index.begin(), index.end()) != test_target)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    bool failed_any = false;
+    std::string test_data = R"({"key": [1, true, null, "a\"b\\", -2.5e3], "k2": {}})";
+    if (!test(test_data))
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 1.\n";
+    }
+
+    // strings and backslash runs crossing 64 byte block boundaries
+    test_data = "[\"" + std::string(70, 'x') + "\\\\\\\"" + std::string(60, '\\') + "\", 1]";
+    if (!test(test_data))
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 2.\n";
+    }
+
+    test_data = "";
+    if (!test(test_data))
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 3.\n";
+    }
+
+    std::mt19937 generator(2137);
+    const std::string alphabet = "{}[],: \t\n\"\"\\\\\\a1-";
+    std::uniform_int_distribution<std::size_t> pick(0, alphabet.size() - 1);
+    std::uniform_int_distribution<std::size_t> length(0, 300);
+    for (int i{0}; i < 2000; i++)
+    {
+        test_data.resize(length(generator));
+        for (auto& c : test_data)
+        {
+            c = alphabet[pick(generator)];
+        }
+        if (!test(test_data))
+        {
+            failed_any = true;
+            std::cerr << "Failed test case 4 with input `" << test_data << "`.\n";
+            break;
+        }
+    }
+
+    return failed_any ? -1 : 0;
+}
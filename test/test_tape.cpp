@@ -0,0 +1,196 @@
+#include "parser.h"
+#include "tape.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#include <variant>
+#include <memory>
+#include <cstdint>
+
+using namespace yajp;
+
+int main()
+{
+    bool failed_any = false;
+    std::string test_data = R"(
+{
+  "id": 9007199254740993,
+  "name": "Leanne Graham",
+  "geo": {"lat": -37.3159, "lng": 81.1496},
+  "tags": ["a", [1, 2, [3]], {}, null, true, false],
+  "empty": []
+}
+    )";
+    Parser parser;
+    TapeDocument document;
+    parser.parse(test_data, document);
+    Element root = document.root();
+
+    if (root.type() != Value::Type::Object || root.get_object().size() != 5)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 1.\n";
+    }
+
+    if (root["id"].get_integer() != 9007199254740993 ||
+        root["name"].get_string() != "Leanne Graham")
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 2.\n";
+    }
+
+    if (root["geo"]["lng"].get_number() != 81.1496 || root["geo"]["lat"].get_number() != -37.3159)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 3.\n";
+    }
+
+    // iteration jumps over nested containers
+    std::vector<Value::Type> types;
+    for (Element element : root["tags"].get_array())
+    {
+        types.push_back(element.type());
+    }
+    std::vector<Value::Type> expected_types = {
+        Value::Type::String,
+        Value::Type::Array,
+        Value::Type::Object,
+        Value::Type::Null,
+        Value::Type::Bool,
+        Value::Type::Bool,
+    };
+    if (types != expected_types || root["tags"].get_array().size() != 6 ||
+        root["tags"][1][2][0].get_integer() != 3 || root["tags"][5].get_bool())
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 4.\n";
+    }
+
+    std::vector<std::string_view> keys;
+    for (auto [key, value] : root.get_object())
+    {
+        keys.push_back(key);
+    }
+    if (keys != std::vector<std::string_view>{"id", "name", "geo", "tags", "empty"} ||
+        root["empty"].get_array().size() != 0)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 5.\n";
+    }
+
+    bool threw_missing = false;
+    bool threw_type = false;
+    try
+    {
+        root["missing"];
+    }
+    catch (const std::out_of_range&)
+    {
+        threw_missing = true;
+    }
+    try
+    {
+        root["name"].get_number();
+    }
+    catch (const std::bad_variant_access&)
+    {
+        threw_type = true;
+    }
+    if (!threw_missing || !threw_type)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 6.\n";
+    }
+
+    parser.parse("[1.5, \"x\"]", document);
+    if (document.root()[0].get_number() != 1.5 || document.root()[1].get_string() != "x")
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 7.\n";
+    }
+
+    // documents parsed against a key table share their keys, the 52 bytes of keys and their
+    // lengths are not in the string buffer
+    Parser::Options options;
+    options.keys = std::make_shared<KeyTable>();
+    Parser interning(options);
+    TapeDocument first;
+    TapeDocument second;
+    interning.parse(test_data, first);
+    interning.parse(
+        R"({"name": "x", "n\u0061me": 1, "geo": {"lat": 0, "new": [{"id": 2}]}})", second);
+    parser.parse(test_data, document);
+    std::size_t interned_keys = options.keys->size();
+    if (first.root()["name"].get_string() != "Leanne Graham" ||
+        first.root()["geo"]["lng"].get_number() != 81.1496 ||
+        second.root()["geo"]["new"][0]["id"].get_integer() != 2 ||
+        second.root().get_object().size() != 3 || interned_keys != 8 ||
+        first.string_buffer_size() + 52 != document.string_buffer_size())
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 8.\n";
+    }
+
+    // of repeated keys the first one is found, keys only in the table or nowhere are missing
+    keys.clear();
+    for (auto [key, value] : second.root().get_object())
+    {
+        keys.push_back(key);
+    }
+    if (keys != std::vector<std::string_view>{"name", "name", "geo"} ||
+        second.root()["name"].get_string() != "x" ||
+        second.root().get_object().find("id") != second.root().get_object().end() ||
+        second.root().get_object().find("unknown") != second.root().get_object().end() ||
+        options.keys->size() != interned_keys ||
+        second.root().to_value().get<Value::Object>().at("geo").get<Value::Object>().size() != 2)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 9.\n";
+    }
+
+    // keys which do not fit into a full table are stored in the document
+    options.keys = std::make_shared<KeyTable>(1, 16);
+    Parser limited(options);
+    limited.parse(R"({"a": 1, "b\\\"": 2, "c": 3, "a": 4, "long\tkey": 5})", second);
+    if (options.keys->size() != 1 || options.keys->bytes() != 1 ||
+        second.root()["a"].get_integer() != 1 || second.root()["b\\\""].get_integer() != 2 ||
+        second.root()["c"].get_integer() != 3 || second.root()["long\tkey"].get_integer() != 5 ||
+        second.root().get_object().find("d") != second.root().get_object().end())
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 10.\n";
+    }
+
+    options.keys->clear();
+    limited.parse(R"({"c": 1, "d": 2, "e": 3})", second);
+    if (options.keys->size() != 1 || options.keys->key(0) != "c" ||
+        second.root()["e"].get_integer() != 3)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 11.\n";
+    }
+
+    // a full table turns new keys away and still finds its own
+    KeyTable table(40);
+    bool table_failed = table.intern("") != 0;
+    for (int i = 0; i < 1000; i++)
+    {
+        std::uint32_t id = table.intern(std::to_string(i));
+        table_failed |= id != (i < 39 ? static_cast<std::uint32_t>(i + 1) : KeyTable::Missing);
+    }
+    for (int i = 0; i < 39; i++)
+    {
+        table_failed |= table.intern(std::to_string(i)) != static_cast<std::uint32_t>(i + 1) ||
+                        table.find(std::to_string(i)) != static_cast<std::uint32_t>(i + 1);
+    }
+    if (table_failed || table.size() != 40 || table.find("39") != KeyTable::Missing ||
+        KeyTable(0).intern("a") != KeyTable::Missing)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 12.\n";
+    }
+
+    return failed_any ? -1 : 0;
+}
@@ -264,5 +264,61 @@ int main()
         std::cerr << "Failed test case 5.\n";
     }
 
+    std::string long_string = "\"" + std::string(40, 'a') + "\\u00e9" + std::string(40, 'b') + "\"";
+    test_data = "[" + long_string + "]";
+    test_target = {
+        Token(Token::Type::LeftBracket, "["),
+        Token(Token::Type::String, long_string),
+        Token(Token::Type::RightBracket, "]"),
+        Token(Token::Type::End, {}),
+    };
+    if (!test(std::move(test_data), test_target))
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 6.\n";
+    }
+
+    test_data = "[\"" + std::string(40, 'a') + "\n\"]";
+    test_target = {
+        Token(Token::Type::LeftBracket, "["),
+        Token(Token::Type::Invalid, {}),
+    };
+    if (!test(std::move(test_data), test_target))
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 7.\n";
+    }
+
+    // indexing in windows of any size produces the same tokens, also where strings, numbers
+    // and runs of whitespace cross window boundaries
+    test_data = "{\"a\": [1, -2.5e10, \"" + std::string(150, 'x') + "\\\" ] ,\", true]," +
+                std::string(200, ' ') + "\"b\" :null, \"c\":{\"d\":[false, 123456789]}}  ";
+    Tokenizer whole(test_data);
+    std::vector<Token> expected = whole.all();
+    bool windows_match = true;
+    for (std::size_t window : {1, 2, 7, 63, 64, 65, 130, 1000})
+    {
+        Tokenizer windowed;
+        windowed.reset(test_data, true, window);
+        std::vector<Token> tokens = windowed.all();
+        windows_match &= tokens.size() == expected.size();
+        for (std::size_t i{0}; windows_match && i < tokens.size(); i++)
+        {
+            windows_match = tokens[i].type() == expected[i].type() &&
+                            tokens[i].value().data() == expected[i].value().data() &&
+                            tokens[i].value().size() == expected[i].value().size();
+        }
+        // seeking to a token start outside of the current window
+        windowed.seek(test_data.find("\"c\""));
+        windows_match &= windowed.next().value() == "\"c\"";
+        windowed.seek(1);
+        windows_match &= windowed.next().value() == "\"a\"";
+    }
+    if (!windows_match)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 8.\n";
+    }
+
     return failed_any ? -1 : 0;
 }
@@ -0,0 +1,127 @@
+#include "typed_serializer.h"
+#include "parser.h"
+#include "binding.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <optional>
+#include <variant>
+#include <limits>
+#include <stdexcept>
+#include <cstdint>
+
+using namespace yajp;
+
+struct Point
+{
+    double x = 0;
+    double y = 0;
+};
+
+struct Shape
+{
+    std::string name;
+    std::vector<Point> points;
+    std::optional<std::uint32_t> color;
+    bool closed = false;
+};
+
+struct Response
+{
+    std::int64_t id = 0;
+    std::variant<std::monostate, std::string, Shape> result;
+    std::map<std::string, std::vector<int>> groups;
+    Value extra;
+};
+
+YAJP_BIND(Point, x, y)
+YAJP_BIND(Shape, name, points, color, closed)
+YAJP_BIND(Response, id, result, groups, extra)
+
+struct Renamed
+{
+    float value = 0;
+    std::int8_t small = 0;
+};
+
+template <>
+struct yajp::Binding<Renamed>
+{
+    static constexpr auto fields =
+        std::make_tuple(field("the value", &Renamed::value), field("s", &Renamed::small));
+};
+
+int main()
+{
+    bool failed_any = false;
+    TypedSerializer serializer;
+
+    Shape shape{"tri\"angle\"\n", {{0, 0}, {1.5, -2}, {0.1, 1e300}}, std::nullopt, true};
+    if (serializer.serialize(shape) !=
+        R"({"name":"tri\"angle\"\n","points":[{"x":0,"y":0},{"x":1.5,"y":-2},)"
+        R"({"x":0.1,"y":1e+300}],"color":null,"closed":true})")
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 1.\n";
+    }
+
+    Response response;
+    response.id = std::numeric_limits<std::int64_t>::min();
+    response.groups = {{"b", {}}, {"a\t", {1, -2}}};
+    response.extra = Parser().parse(R"({"k": [null]})");
+    if (serializer.serialize(response) !=
+        R"({"id":-9223372036854775808,"result":null,"groups":{"a\t":[1,-2],"b":[]},)"
+        R"("extra":{"k":[null]}})")
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 2.\n";
+    }
+
+    // variants write their current alternative
+    response.result = std::string("done");
+    response.extra = Value();
+    response.groups.clear();
+    std::string output = "prefix ";
+    serializer.serialize(response, output);
+    response.result = shape;
+    std::get<Shape>(response.result).color = 0xFF0000;
+    std::get<Shape>(response.result).points.clear();
+    if (output !=
+            R"(prefix {"id":-9223372036854775808,"result":"done","groups":{},"extra":null})" ||
+        serializer.serialize(response) !=
+            R"({"id":-9223372036854775808,"result":{"name":"tri\"angle\"\n","points":[],)"
+            R"("color":16711680,"closed":true},"groups":{},"extra":null})")
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 3.\n";
+    }
+
+    // what is written parses back into the same struct
+    std::vector<Renamed> list{{0.25f, -128}, {3.0f, 127}};
+    std::vector<Renamed> parsed;
+    Parser().parse_into(std::string(serializer.serialize(list)), parsed);
+    if (serializer.serialize(list) != R"([{"the value":0.25,"s":-128},{"the value":3,"s":127}])" ||
+        parsed.size() != 2 || parsed[0].value != 0.25f || parsed[1].small != 127)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 4.\n";
+    }
+
+    bool threw = false;
+    try
+    {
+        serializer.serialize(Point{std::numeric_limits<double>::quiet_NaN(), 0});
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    if (!threw)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 5.\n";
+    }
+
+    return failed_any ? -1 : 0;
+}
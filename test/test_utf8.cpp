@@ -0,0 +1,208 @@
+#include "utf8.h"
+#include "structural_index.h"
+#include "parser.h"
+#include "line_parser.h"
+#include "simd.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <iostream>
+#include <random>
+#include <cstddef>
+#include <cstdint>
+
+using namespace yajp;
+
+// Decodes every sequence and checks the code point, rather than the allowed byte ranges.
+bool reference_valid(std::string_view input)
+{
+    for (std::size_t i{0}; i < input.size();)
+    {
+        unsigned char lead = static_cast<unsigned char>(input[i]);
+        std::size_t length = lead < 0x80 ? 1 : lead >> 5 == 0x6 ? 2 : lead >> 4 == 0xE ? 3
+                                           : lead >> 3 == 0x1E ? 4 : 0;
+        if (length == 0 || i + length > input.size())
+        {
+            return false;
+        }
+        std::uint32_t code_point = length == 1 ? lead : lead & (0x7F >> length);
+        for (std::size_t k{1}; k < length; k++)
+        {
+            unsigned char c = static_cast<unsigned char>(input[i + k]);
+            if (c >> 6 != 0x2)
+            {
+                return false;
+            }
+            code_point = code_point << 6 | (c & 0x3F);
+        }
+        static constexpr std::uint32_t minimum[] = {0, 0, 0x80, 0x800, 0x10000};
+        if (code_point < minimum[length] || code_point > 0x10FFFF ||
+            (code_point >= 0xD800 && code_point < 0xE000))
+        {
+            return false;
+        }
+        i += length;
+    }
+    return true;
+}
+
+bool test(std::string_view test_data)
+{
+    bool test_target = reference_valid(test_data);
+    for (int level = 0; level <= static_cast<int>(simd::detect()); level++)
+    {
+        StructuralIndex index;
+        index.build(test_data, static_cast<simd::Level>(level), true);
+        if (is_valid_utf8(test_data, static_cast<simd::Level>(level)) != test_target ||
+            index.valid_utf8() != test_target)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void append_code_point(std::string& output, std::uint32_t code_point)
+{
+    if (code_point < 0x80)
+    {
+        output += static_cast<char>(code_point);
+    }
+    else if (code_point < 0x800)
+    {
+        output += static_cast<char>(0xC0 | code_point >> 6);
+        output += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+    else if (code_point < 0x10000)
+    {
+        output += static_cast<char>(0xE0 | code_point >> 12);
+        output += static_cast<char>(0x80 | (code_point >> 6 & 0x3F));
+        output += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+    else
+    {
+        output += static_cast<char>(0xF0 | code_point >> 18);
+        output += static_cast<char>(0x80 | (code_point >> 12 & 0x3F));
+        output += static_cast<char>(0x80 | (code_point >> 6 & 0x3F));
+        output += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+}
+
+int main()
+{
+    bool failed_any = false;
+    const char* cases[] = {
+        "",
+        "plain ascii",
+        "\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80",
+        "\xc0\xaf",             // overlong
+        "\xe0\x80\xaf",         // overlong
+        "\xed\xa0\x80",         // surrogate
+        "\xf4\x90\x80\x80",     // above U+10FFFF
+        "\xf5\x80\x80\x80",     // invalid lead
+        "\x80",                 // stray continuation
+        "\xe2\x82",             // truncated
+        "\xc3\xa9\xc3",         // truncated
+    };
+    for (std::size_t i{0}; i < std::size(cases); i++)
+    {
+        if (!test(cases[i]))
+        {
+            failed_any = true;
+            std::cerr << "Failed test case 1 with input " << i << ".\n";
+        }
+    }
+
+    // sequences at every offset around block boundaries, valid or with one byte corrupted
+    std::mt19937 random(7);
+    std::uniform_int_distribution<std::uint32_t> planes(0, 3);
+    for (int i = 0; i < 3000; i++)
+    {
+        std::string test_data(random() % 70, 'x');
+        while (test_data.size() < 200)
+        {
+            std::uint32_t limit[] = {0x7F, 0x7FF, 0xFFFF, 0x10FFFF};
+            std::uint32_t code_point = random() % (limit[planes(random)] + 1);
+            if (code_point >= 0xD800 && code_point < 0xE000)
+            {
+                continue;
+            }
+            append_code_point(test_data, code_point);
+        }
+        switch (i % 3)
+        {
+        case 0:
+            test_data[random() % test_data.size()] = static_cast<char>(random());
+            break;
+        case 1:
+            test_data.resize(random() % test_data.size());
+            break;
+        default:
+            break;
+        }
+        if (!test(test_data))
+        {
+            failed_any = true;
+            std::cerr << "Failed test case 2 with iteration " << i << ".\n";
+        }
+    }
+
+    Parser::Options options;
+    options.validate_utf8 = true;
+    Parser parser(options);
+    std::string invalid = "{\"key\": \"\xed\xa0\x80\"}";
+    int rejected = 0;
+    auto expect_error = [&](auto function)
+    {
+        try
+        {
+            function();
+        }
+        catch (const ParserError&)
+        {
+            rejected++;
+        }
+    };
+    expect_error([&] { parser.parse(invalid); });
+    expect_error([&] { parser.parse_lazy(invalid); });
+    expect_error([&] { parser.parse_parallel(invalid, 2); });
+    expect_error(
+        [&]
+        {
+            // the sequence is split between chunks, then cut off
+            parser.feed("[\"\xe2\x82");
+            parser.feed("\xac\", \"\xe2");
+            parser.finish();
+        });
+    parser.feed("[\"\xe2\x82");
+    parser.feed("\xac\"]");
+    Value value = parser.finish();
+    if (rejected != 4 || Parser().parse(invalid).type() != Value::Type::Object ||
+        value.get<Value::Array>()[0].get<Value::String>() != "\xe2\x82\xac")
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 3.\n";
+    }
+
+    LineParser::Options line_options;
+    line_options.validate_utf8 = true;
+    line_options.chunk_size = 8;
+    std::size_t values = 0;
+    std::size_t error_line = 0;
+    try
+    {
+        LineParser(line_options)
+            .parse("\"\xc3\xa9\"\n1\n\n\"\xc3\"\n2\n", [&](std::size_t, Value&&) { values++; });
+    }
+    catch (const LineError& error)
+    {
+        error_line = error.line();
+    }
+    if (values != 2 || error_line != 4)
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 4.\n";
+    }
+
+    return failed_any ? -1 : 0;
+}
@@ -0,0 +1,99 @@
+#include "parser.h"
+#include <iostream>
+#include <string>
+
+using namespace yajp;
+
+using Error = ValidationResult::Error;
+
+bool test(const std::string& test_data, Error error, std::size_t offset, bool utf8 = false)
+{
+    Parser::Options options;
+    options.validate_utf8 = utf8;
+    Parser parser(options);
+    ValidationResult result = parser.validate(test_data);
+    if (result.error != error || (error != Error::None && result.offset != offset))
+    {
+        std::cerr << "`" << test_data << "`: " << result.message() << " at " << result.offset
+                  << ".\n";
+        return false;
+    }
+    // validation accepts exactly what parsing accepts
+    bool parsed = true;
+    try
+    {
+        parser.parse(test_data);
+    }
+    catch (const ParserError&)
+    {
+        parsed = false;
+    }
+    return parsed == result.valid();
+}
+
+int main()
+{
+    bool failed_any = false;
+
+    if (!test(R"({"a": [1, -2.5e3, "x\né", true, false, null, {}], "b": {"c": []}})",
+              Error::None, 0))
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 1.\n";
+    }
+
+    if (!test(R"({"a": [1, 2,]})", Error::UnexpectedToken, 12) ||
+        !test(R"({"a" 1})", Error::UnexpectedToken, 5) ||
+        !test(R"([1}])", Error::UnexpectedToken, 2))
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 2.\n";
+    }
+
+    if (!test(R"([1, 01])", Error::InvalidToken, 4) ||
+        !test(R"(["a\x"])", Error::InvalidToken, 1) || !test(R"([tru])", Error::InvalidToken, 1) ||
+        !test("[\"a\x7f\"]", Error::InvalidToken, 1) ||
+        !test("[\"" + std::string(40, 'a') + "\x7f\"]", Error::InvalidToken, 1))
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 3.\n";
+    }
+
+    if (!test(R"({"a": [1, 2])", Error::UnexpectedEnd, 12) || !test("", Error::UnexpectedEnd, 0) ||
+        !test("  ", Error::UnexpectedEnd, 2))
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 4.\n";
+    }
+
+    if (!test(R"({} [])", Error::TrailingContent, 3) || !test("1 2", Error::TrailingContent, 2))
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 5.\n";
+    }
+
+    // only reported when asked for
+    std::string invalid_utf8 = "[\"ab\xc3\x28\"]";
+    if (!test(invalid_utf8, Error::InvalidUtf8, 5, true) || !test(invalid_utf8, Error::None, 0))
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 6.\n";
+    }
+
+    // validation keeps no stack of values, so its nesting is only limited by memory; parse() is
+    // left out since destroying a Value this deep would overflow the stack
+    std::string deep = std::string(100000, '[') + std::string(100000, ']');
+    Parser parser;
+    ValidationResult deep_result = parser.validate(deep);
+    ValidationResult trailing_result = parser.validate(deep + "]");
+    std::string nested = std::string(1000, '[') + std::string(1000, ']');
+    if (!deep_result.valid() || trailing_result.error != Error::TrailingContent ||
+        trailing_result.offset != deep.size() || !test(nested, Error::None, 0) ||
+        !test(nested + "]", Error::TrailingContent, nested.size()))
+    {
+        failed_any = true;
+        std::cerr << "Failed test case 7.\n";
+    }
+
+    return failed_any ? -1 : 0;
+}